@@ -75,6 +75,28 @@ public:
 		}
 	}
 
+	Atom(Atom&& move)
+		: _atom(move._atom)
+		, _body(move._body)
+	{
+		move._atom.size = 0;
+		move._atom.type = 0;
+		move._body.ptr  = NULL;
+	}
+
+	Atom& operator=(Atom&& other) {
+		if (&other == this) {
+			return *this;
+		}
+		dealloc();
+		_atom            = other._atom;
+		_body            = other._body;
+		other._atom.size = 0;
+		other._atom.type = 0;
+		other._body.ptr  = NULL;
+		return *this;
+	}
+
 	Atom& operator=(const Atom& other) {
 		if (&other == this) {
 			return *this;
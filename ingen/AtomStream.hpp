@@ -0,0 +1,124 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEN_ATOM_STREAM_HPP
+#define INGEN_ATOM_STREAM_HPP
+
+#include <stdint.h>
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "ingen/ingen.h"
+#include "lv2/lv2plug.in/ns/ext/atom/atom.h"
+#include "raul/Noncopyable.hpp"
+
+namespace Ingen {
+
+class URIMap;
+
+/** Binary framing of LV2 atom messages for streams between processes.
+ *
+ * Socket connections use Turtle by default.  A server that also supports
+ * atom streams greets each new connection with GREETING, which is a Turtle
+ * comment and thus ignored by older clients.  A client may reply with MAGIC
+ * as the very first thing it sends, after which both sides send atoms.
+ *
+ * Each frame is an LV2_Atom header and body, padded to 64 bits.  Since URIDs
+ * are local to a process, a URID is declared before the first message that
+ * uses it, in a frame of type 0 whose body is the URID followed by its URI
+ * as a null terminated string.
+ */
+class INGEN_API AtomStream : public Raul::Noncopyable
+{
+public:
+	enum class Format {
+		TURTLE,  ///< Turtle text, parsed as RDF
+		ATOM     ///< Binary atoms
+	};
+
+	static const char* const GREETING;  ///< Sent by server on connection
+	static const char* const MAGIC;     ///< Sent by client to use atoms
+
+	/** Maximum size of a received frame body. */
+	static const uint32_t MAX_FRAME_SIZE = 1 << 24;
+
+	/** Time for a client to wait for GREETING, in milliseconds.
+	 *
+	 * Servers greet as soon as they accept a connection, so this is only
+	 * waited in full when connecting to an older server without atom support,
+	 * which delays the connection by this long.  If the greeting arrives late,
+	 * Turtle is used, which is always safe since it is a comment.
+	 */
+	static const int GREETING_TIMEOUT_MS = 100;
+
+	explicit AtomStream(URIMap& map);
+
+	/** Wait for the peer on socket `fd` to send `magic` and consume it.
+	 *
+	 * This returns as soon as the input does not match, leaving it to be
+	 * read as Turtle, so it only waits for the full timeout if the peer sends
+	 * nothing at all.
+	 *
+	 * @return ATOM iff `magic` was received within `timeout_ms`.
+	 */
+	static Format negotiate(int fd, const char* magic, int timeout_ms);
+
+	/** Check without blocking if the peer on socket `fd` has sent `magic`.
+	 *
+	 * @return 1 if `magic` was received and consumed, 0 if the input so far
+	 * is the start of `magic`, or -1 on mismatch or hangup.
+	 */
+	static int check_magic(int fd, const char* magic);
+
+	/** Append frames for `msg` to `out`.
+	 *
+	 * These start with declarations of any URIDs used by `msg` that have not
+	 * been written to this stream yet.
+	 *
+	 * @return False if `msg` is malformed or uses an unknown URID, in which
+	 * case `out` is left unchanged.
+	 */
+	bool write(const LV2_Atom* msg, std::vector<uint8_t>& out);
+
+	/** Process a received frame in place.
+	 *
+	 * Declarations are recorded, and URIDs in messages are translated to
+	 * those of this process.
+	 *
+	 * @return True iff `frame` is now a message ready to be read.
+	 */
+	bool read(LV2_Atom* frame, uint32_t size);
+
+private:
+	template<typename Visit>
+	bool visit_urids(LV2_Atom* atom, const uint8_t* end, Visit visit);
+
+	URIMap&                                _map;
+	const uint32_t                         _atom_Literal;
+	const uint32_t                         _atom_Object;
+	const uint32_t                         _atom_Sequence;
+	const uint32_t                         _atom_Tuple;
+	const uint32_t                         _atom_URID;
+	const uint32_t                         _atom_Vector;
+	std::unordered_set<uint32_t>           _declared;  ///< Sent local URIDs
+	std::unordered_map<uint32_t, uint32_t> _urids;     ///< Remote to local
+};
+
+}  // namespace Ingen
+
+#endif  // INGEN_ATOM_STREAM_HPP
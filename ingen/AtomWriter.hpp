@@ -74,6 +74,11 @@ public:
 	                  const Raul::URI& predicate,
 	                  const Atom&      value);
 
+	/** Set a property with a predicate that is already mapped to a URID. */
+	void set_property(const Raul::URI& subject,
+	                  LV2_URID         predicate,
+	                  const LV2_Atom*  value);
+
 	void set_response_id(int32_t id);
 
 	void get(const Raul::URI& uri);
@@ -75,6 +75,8 @@ public:
 		return Atom(v.length() + 1, URI, v.c_str());
 	}
 
+	URIMap& uri_map() const { return _map; }
+
 private:
 	URIMap& _map;
 };
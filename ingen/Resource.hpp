@@ -18,17 +18,26 @@
 #define INGEN_RESOURCE_HPP
 
 #include <map>
+#include <memory>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "ingen/Atom.hpp"
 #include "ingen/URIs.hpp"
 #include "ingen/ingen.h"
+#include "lv2/lv2plug.in/ns/ext/urid/urid.h"
 #include "raul/Deletable.hpp"
 #include "raul/URI.hpp"
 
 namespace Ingen {
 
 /** An object with a URI described by properties.
+ *
+ * Properties are stored compactly keyed by the URID of their predicate, and
+ * converted to Properties (keyed by URI) only when all of them are requested,
+ * typically to send them through an Interface.
+ *
  * @ingroup Ingen
  */
 class INGEN_API Resource : public Raul::Deletable
@@ -107,6 +116,13 @@ public:
 			: std::multimap<Raul::URI, Property>(copy)
 		{}
 
+		Properties(Properties&& move)
+			: std::multimap<Raul::URI, Property>(std::move(move))
+		{}
+
+		Properties& operator=(const Properties& copy) = default;
+		Properties& operator=(Properties&& move)      = default;
+
 		Properties(std::initializer_list<value_type> l)
 			: std::multimap<Raul::URI, Property>(l)
 		{}
@@ -114,16 +130,60 @@ public:
 		void put(const Raul::URI& key,
 		         const Atom&      value,
 		         Graph            ctx = Graph::DEFAULT) {
-			insert(std::make_pair(key, Property(value, ctx)));
+			emplace(key, Property(value, ctx));
 		}
 
 		void put(const Raul::URI&   key,
 		         const URIs::Quark& value,
 		         Graph              ctx = Graph::DEFAULT) {
-			insert(std::make_pair(key, Property(value, ctx)));
+			emplace(key, Property(value, ctx));
 		}
 	};
 
+	/** Properties of a resource, stored by predicate URID.
+	 *
+	 * Entries are sorted by key, and values with the same key are kept in the
+	 * order they were added.  Values are allocated individually, so references
+	 * to them remain valid until they are removed.
+	 */
+	class PropertyTable {
+	public:
+		struct Entry {
+			LV2_URID                  key;
+			std::unique_ptr<Property> value;
+		};
+
+		typedef std::vector<Entry>::iterator       iterator;
+		typedef std::vector<Entry>::const_iterator const_iterator;
+
+		PropertyTable() {}
+		PropertyTable(const PropertyTable& copy) { *this = copy; }
+		PropertyTable(PropertyTable&& move) = default;
+
+		PropertyTable& operator=(const PropertyTable& copy);
+		PropertyTable& operator=(PropertyTable&& move) = default;
+
+		iterator       begin()       { return _entries.begin(); }
+		iterator       end()         { return _entries.end(); }
+		const_iterator begin() const { return _entries.begin(); }
+		const_iterator end()   const { return _entries.end(); }
+
+		/** Return the range of entries with predicate `key`. */
+		std::pair<iterator, iterator>             equal_range(LV2_URID key);
+		std::pair<const_iterator, const_iterator> equal_range(LV2_URID key) const;
+
+		/** Add a value after any others for `key`, and return it. */
+		Property& insert(LV2_URID key, const Property& value);
+
+		iterator erase(iterator i)                 { return _entries.erase(i); }
+		iterator erase(iterator begin, iterator end) {
+			return _entries.erase(begin, end);
+		}
+
+	private:
+		std::vector<Entry> _entries;
+	};
+
 	/** Get a single property value.
 	 *
 	 * This is only useful for properties with a single value.  If the
@@ -236,10 +296,15 @@ public:
 	/** Get all the properties with a given context. */
 	Properties properties(Resource::Graph ctx) const;
 
-	const URIs&       uris()       const { return _uris; }
-	const Raul::URI&  uri()        const { return _uri; }
-	const Properties& properties() const { return _properties; }
-	Properties&       properties()       { return _properties; }
+	/** Get all the properties.
+	 *
+	 * This returns a new Properties keyed by URI, so it is relatively
+	 * expensive.  Use get_property() or has_property() to look up values.
+	 */
+	Properties properties() const;
+
+	const URIs&      uris() const { return _uris; }
+	const Raul::URI& uri()  const { return _uri; }
 
 protected:
 	const Atom& set_property(const Raul::URI& uri, const Atom& value) const;
@@ -247,8 +312,14 @@ protected:
 	const URIs& _uris;
 
 private:
-	Raul::URI          _uri;
-	mutable Properties _properties;
+	/** Return the URID of predicate `uri`. */
+	LV2_URID key(const Raul::URI& uri) const;
+
+	/** Return the URI of predicate `key`. */
+	Raul::URI key_uri(LV2_URID key) const;
+
+	Raul::URI     _uri;
+	PropertyTable _properties;
 };
 
 } // namespace Ingen
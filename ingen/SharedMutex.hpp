@@ -0,0 +1,136 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEN_SHAREDMUTEX_HPP
+#define INGEN_SHAREDMUTEX_HPP
+
+#include <condition_variable>
+#include <mutex>
+
+#include "raul/Noncopyable.hpp"
+
+namespace Ingen {
+
+/** A mutex that may be held by one writer, or by many readers at once.
+ *
+ * This has the same interface as std::shared_timed_mutex without timeouts, so
+ * std::unique_lock can be used for exclusive access, and SharedLock for shared
+ * access.  Writers take priority: once a writer is waiting, new readers wait
+ * until it is finished, so a steady stream of readers can not starve it.
+ *
+ * Unlike std::mutex, this may be unlocked by a different thread than the one
+ * that locked it.
+ *
+ * @ingroup IngenShared
+ */
+class SharedMutex : public Raul::Noncopyable {
+public:
+	SharedMutex() : _n_readers(0), _n_writers_waiting(0), _writer(false) {}
+
+	void lock() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		++_n_writers_waiting;
+		_cond.wait(lock, [this]{ return !_writer && !_n_readers; });
+		--_n_writers_waiting;
+		_writer = true;
+	}
+
+	bool try_lock() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_writer || _n_readers) {
+			return false;
+		}
+		_writer = true;
+		return true;
+	}
+
+	void unlock() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_writer = false;
+		_cond.notify_all();
+	}
+
+	void lock_shared() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_cond.wait(lock, [this]{ return !_writer && !_n_writers_waiting; });
+		++_n_readers;
+	}
+
+	bool try_lock_shared() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_writer || _n_writers_waiting) {
+			return false;
+		}
+		++_n_readers;
+		return true;
+	}
+
+	void unlock_shared() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (--_n_readers == 0) {
+			_cond.notify_all();
+		}
+	}
+
+private:
+	std::mutex              _mutex;
+	std::condition_variable _cond;
+	unsigned                _n_readers;
+	unsigned                _n_writers_waiting;
+	bool                    _writer;
+};
+
+/** Scoped shared (reader) lock on a SharedMutex, like std::shared_lock. */
+class SharedLock : public Raul::Noncopyable {
+public:
+	explicit SharedLock(SharedMutex& mutex)
+		: _mutex(mutex)
+		, _owns(true)
+	{
+		mutex.lock_shared();
+	}
+
+	SharedLock(SharedMutex& mutex, std::try_to_lock_t)
+		: _mutex(mutex)
+		, _owns(mutex.try_lock_shared())
+	{}
+
+	SharedLock(SharedMutex& mutex, std::defer_lock_t)
+		: _mutex(mutex)
+		, _owns(false)
+	{}
+
+	~SharedLock() {
+		if (_owns) {
+			_mutex.unlock_shared();
+		}
+	}
+
+	void lock() {
+		_mutex.lock_shared();
+		_owns = true;
+	}
+
+	bool owns_lock() const { return _owns; }
+
+private:
+	SharedMutex& _mutex;
+	bool         _owns;
+};
+
+} // namespace Ingen
+
+#endif // INGEN_SHAREDMUTEX_HPP
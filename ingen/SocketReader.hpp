@@ -19,7 +19,9 @@
 
 #include <thread>
 
+#include "ingen/AtomStream.hpp"
 #include "ingen/ingen.h"
+#include "ingen/types.hpp"
 #include "raul/Socket.hpp"
 #include "sord/sord.h"
 
@@ -28,13 +30,15 @@ namespace Ingen {
 class Interface;
 class World;
 
-/** Calls Interface methods based on Turtle messages received via socket. */
+/** Calls Interface methods based on Turtle or atom messages received via
+ * socket. */
 class INGEN_API SocketReader
 {
 public:
 	SocketReader(World&             world,
 	             Interface&         iface,
-	             SPtr<Raul::Socket> sock);
+	             SPtr<Raul::Socket> sock,
+	             AtomStream::Format format = AtomStream::Format::TURTLE);
 
 	virtual ~SocketReader();
 
@@ -43,6 +47,7 @@ protected:
 
 private:
 	void run();
+	void run_atoms();
 
 	static SerdStatus set_base_uri(SocketReader*   iface,
 	                               const SerdNode* uri_node);
@@ -62,10 +67,12 @@ private:
 
 	World&             _world;
 	Interface&         _iface;
+	SordWorld*         _rdf_world;  ///< Private world for parsing
 	SerdEnv*           _env;
 	SordInserter*      _inserter;
 	SordNode*          _msg_node;
 	SPtr<Raul::Socket> _socket;
+	AtomStream::Format _format;
 	bool               _exit_flag;
 	std::thread        _thread;
 };
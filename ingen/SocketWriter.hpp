@@ -19,7 +19,10 @@
 
 #include <stdint.h>
 
+#include <vector>
+
 #include "ingen/AtomSink.hpp"
+#include "ingen/AtomStream.hpp"
 #include "ingen/AtomWriter.hpp"
 #include "ingen/Interface.hpp"
 #include "ingen/types.hpp"
@@ -30,7 +33,7 @@
 
 namespace Ingen {
 
-/** An Interface that writes Turtle messages to a socket.
+/** An Interface that writes Turtle or atom messages to a socket.
  */
 class INGEN_API SocketWriter : public AtomWriter, public AtomSink
 {
@@ -38,27 +41,37 @@ public:
 	SocketWriter(URIMap&            map,
 	             URIs&              uris,
 	             const Raul::URI&   uri,
-	             SPtr<Raul::Socket> sock);
+	             SPtr<Raul::Socket> sock,
+	             AtomStream::Format format = AtomStream::Format::TURTLE);
 
 	~SocketWriter();
 
 	bool write(const LV2_Atom* msg);
 
-	void bundle_end();
+	/** Send serialised output to the socket.
+	 *
+	 * This blocks until everything is sent, but may be overridden to queue
+	 * output instead.
+	 */
+	virtual bool write_bytes(const void* buf, size_t len);
 
 	int         fd()        { return _socket->fd(); }
 	Raul::URI   uri() const { return _uri; }
 	SerdWriter* writer()    { return _writer; }
 
 protected:
-	URIMap&            _map;
-	Sratom*            _sratom;
-	SerdNode           _base;
-	SerdURI            _base_uri;
-	SerdEnv*           _env;
-	SerdWriter*        _writer;
-	Raul::URI          _uri;
-	SPtr<Raul::Socket> _socket;
+	URIMap&              _map;
+	URIs&                _uris;
+	AtomStream::Format   _format;
+	AtomStream           _stream;
+	std::vector<uint8_t> _buf;
+	Sratom*              _sratom;
+	SerdNode             _base;
+	SerdURI              _base_uri;
+	SerdEnv*             _env;
+	SerdWriter*          _writer;
+	Raul::URI            _uri;
+	SPtr<Raul::Socket>   _socket;
 };
 
 }  // namespace Ingen
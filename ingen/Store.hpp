@@ -18,9 +18,11 @@
 #define INGEN_STORE_HPP
 
 #include <map>
-#include <mutex>
+#include <string>
+#include <unordered_map>
 
 #include "ingen/Node.hpp"
+#include "ingen/SharedMutex.hpp"
 #include "ingen/ingen.h"
 #include "ingen/types.hpp"
 #include "raul/Deletable.hpp"
@@ -29,12 +31,21 @@
 namespace Ingen {
 
 /** Store of objects in the graph hierarchy.
+ *
+ * Objects are kept in a map ordered by path, so descendants of an object are
+ * contiguous, and also in a hash index so lookup by path is constant time.
+ * The modifying methods of std::map are hidden here to keep the two in sync.
+ *
  * @ingroup IngenShared
  */
 class INGEN_API Store : public Raul::Noncopyable
                       , public Raul::Deletable
                       , public std::map< const Raul::Path, SPtr<Node> > {
 public:
+	typedef std::map< const Raul::Path, SPtr<Node> > Base;
+
+	Store() : _generation(0) {}
+
 	void add(Node* o);
 
 	Node* get(const Raul::Path& path) {
@@ -42,6 +53,22 @@ public:
 		return (i == end()) ? NULL : i->second.get();
 	}
 
+	iterator       find(const Raul::Path& path);
+	const_iterator find(const Raul::Path& path) const;
+
+	size_type count(const Raul::Path& path) const {
+		return _index.count(&path);
+	}
+
+	std::pair<iterator, bool> insert(const value_type& value);
+
+	SPtr<Node>& operator[](const Raul::Path& path);
+
+	void      erase(iterator i);
+	void      erase(iterator first, iterator last);
+	size_type erase(const Raul::Path& path);
+	void      clear();
+
 	typedef std::pair<const_iterator, const_iterator> const_range;
 
 	typedef std::map< Raul::Path, SPtr<Node> > Objects;
@@ -70,10 +97,40 @@ public:
 	                           const Raul::Symbol& symbol,
 	                           bool                allow_zero=true) const;
 
-	std::mutex& mutex() { return _mutex; }
+	/** Return the mutex which protects the store and the objects in it.
+	 *
+	 * Hold this exclusively (with std::unique_lock) to modify the graph, or
+	 * shared (with SharedLock) to only read it.
+	 */
+	SharedMutex& mutex() { return _mutex; }
+
+	/** Return a number which changes whenever objects are added or removed.
+	 *
+	 * This can be compared to a previous value to cheaply check if anything
+	 * derived from the contents of the store is still valid.
+	 */
+	uint64_t generation() const { return _generation; }
 
 private:
-	std::mutex _mutex;
+	/** Hash of a path referred to by pointer (the key of a map node). */
+	struct PathHash {
+		size_t operator()(const Raul::Path* path) const {
+			return std::hash<std::string>()(*path);
+		}
+	};
+
+	struct PathEqual {
+		bool operator()(const Raul::Path* a, const Raul::Path* b) const {
+			return *a == *b;
+		}
+	};
+
+	typedef std::unordered_map<const Raul::Path*, iterator, PathHash, PathEqual>
+		Index;
+
+	Index       _index;
+	SharedMutex _mutex;
+	uint64_t    _generation;
 };
 
 } // namespace Ingen
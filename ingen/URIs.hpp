@@ -100,6 +100,8 @@ public:
 	const Quark doap_name;
 	const Quark ingen_Arc;
 	const Quark ingen_Block;
+	const Quark ingen_BundleEnd;
+	const Quark ingen_BundleStart;
 	const Quark ingen_Graph;
 	const Quark ingen_GraphPrototype;
 	const Quark ingen_Internal;
@@ -109,14 +111,19 @@ public:
 	const Quark ingen_broadcast;
 	const Quark ingen_canvasX;
 	const Quark ingen_canvasY;
+	const Quark ingen_cpuLoad;
+	const Quark ingen_cycleStats;
 	const Quark ingen_enabled;
+	const Quark ingen_eventPoolSize;
 	const Quark ingen_file;
 	const Quark ingen_head;
 	const Quark ingen_incidentTo;
 	const Quark ingen_loadedBundle;
 	const Quark ingen_polyphonic;
 	const Quark ingen_polyphony;
+	const Quark ingen_profile;
 	const Quark ingen_prototype;
+	const Quark ingen_sampleAccurate;
 	const Quark ingen_sprungLayout;
 	const Quark ingen_tail;
 	const Quark ingen_uiEmbedded;
@@ -17,6 +17,11 @@
 #ifndef INGEN_CLIENT_SOCKET_CLIENT_HPP
 #define INGEN_CLIENT_SOCKET_CLIENT_HPP
 
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include "ingen/AtomStream.hpp"
 #include "ingen/SocketReader.hpp"
 #include "ingen/SocketWriter.hpp"
 #include "ingen/ingen.h"
@@ -31,10 +36,11 @@ public:
 	SocketClient(World&             world,
 	             const Raul::URI&   uri,
 	             SPtr<Raul::Socket> sock,
-	             SPtr<Interface>    respondee)
-		: SocketWriter(world.uri_map(), world.uris(), uri, sock)
+	             SPtr<Interface>    respondee,
+	             AtomStream::Format format = AtomStream::Format::TURTLE)
+		: SocketWriter(world.uri_map(), world.uris(), uri, sock, format)
 		, _respondee(respondee)
-		, _reader(world, *respondee.get(), sock)
+		, _reader(world, *respondee.get(), sock, format)
 	{}
 
 	virtual SPtr<Interface> respondee() const {
@@ -60,7 +66,21 @@ public:
 			                   % sock->uri() % strerror(errno));
 			return SPtr<Interface>();
 		}
-		return SPtr<Interface>(new SocketClient(*world, uri, sock, respondee));
+
+		/* Switch to atoms if the server greets us with support for them.  This
+		   blocks for a moment if the server is too old to greet at all. */
+		const AtomStream::Format format = AtomStream::negotiate(
+			sock->fd(), AtomStream::GREETING, AtomStream::GREETING_TIMEOUT_MS);
+		if (format == AtomStream::Format::ATOM &&
+		    send(sock->fd(), AtomStream::MAGIC, strlen(AtomStream::MAGIC), 0)
+		    != (ssize_t)strlen(AtomStream::MAGIC)) {
+			world->log().error(fmt("Failed to negotiate with <%1%> (%2%)\n")
+			                   % sock->uri() % strerror(errno));
+			return SPtr<Interface>();
+		}
+
+		return SPtr<Interface>(
+			new SocketClient(*world, uri, sock, respondee, format));
 	}
 
 	static void register_factories(World* world) {
@@ -38,6 +38,8 @@
 
 #define INGEN__Arc            INGEN_NS "Arc"
 #define INGEN__Block          INGEN_NS "Block"
+#define INGEN__BundleEnd      INGEN_NS "BundleEnd"
+#define INGEN__BundleStart    INGEN_NS "BundleStart"
 #define INGEN__Graph          INGEN_NS "Graph"
 #define INGEN__GraphPrototype INGEN_NS "GraphPrototype"
 #define INGEN__Internal       INGEN_NS "Internal"
@@ -49,14 +51,19 @@
 #define INGEN__broadcast      INGEN_NS "broadcast"
 #define INGEN__canvasX        INGEN_NS "canvasX"
 #define INGEN__canvasY        INGEN_NS "canvasY"
+#define INGEN__cpuLoad        INGEN_NS "cpuLoad"
+#define INGEN__cycleStats     INGEN_NS "cycleStats"
 #define INGEN__enabled        INGEN_NS "enabled"
+#define INGEN__eventPoolSize  INGEN_NS "eventPoolSize"
 #define INGEN__file           INGEN_NS "file"
 #define INGEN__head           INGEN_NS "head"
 #define INGEN__incidentTo     INGEN_NS "incidentTo"
 #define INGEN__loadedBundle   INGEN_NS "loadedBundle"
 #define INGEN__polyphonic     INGEN_NS "polyphonic"
 #define INGEN__polyphony      INGEN_NS "polyphony"
+#define INGEN__profile        INGEN_NS "profile"
 #define INGEN__prototype      INGEN_NS "prototype"
+#define INGEN__sampleAccurate INGEN_NS "sampleAccurate"
 #define INGEN__sprungLayout   INGEN_NS "sprungLayout"
 #define INGEN__tail           INGEN_NS "tail"
 #define INGEN__uiEmbedded     INGEN_NS "uiEmbedded"
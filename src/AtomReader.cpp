@@ -125,7 +125,9 @@ AtomReader::is_message(const URIs& uris, const LV2_Atom* msg)
 	        obj->body.otype == uris.patch_Set ||
 	        obj->body.otype == uris.patch_Patch ||
 	        obj->body.otype == uris.patch_Move ||
-	        obj->body.otype == uris.patch_Response);
+	        obj->body.otype == uris.patch_Response ||
+	        obj->body.otype == uris.ingen_BundleStart ||
+	        obj->body.otype == uris.ingen_BundleEnd);
 }
 
 bool
@@ -343,6 +345,10 @@ AtomReader::write(const LV2_Atom* msg)
 		_iface.response(((const LV2_Atom_Int*)seq)->body,
 		                (Ingen::Status)((const LV2_Atom_Int*)body)->body,
 		                subject_uri ? subject_uri->c_str() : "");
+	} else if (obj->body.otype == _uris.ingen_BundleStart) {
+		_iface.bundle_begin();
+	} else if (obj->body.otype == _uris.ingen_BundleEnd) {
+		_iface.bundle_end();
 	} else {
 		_log.warn(fmt("Unknown object type <%1%>\n")
 		          % _map.unmap_uri(obj->body.otype));
@@ -0,0 +1,283 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "ingen/AtomStream.hpp"
+#include "ingen/URIMap.hpp"
+#include "lv2/lv2plug.in/ns/ext/atom/util.h"
+
+namespace Ingen {
+
+const char* const AtomStream::GREETING = "# ingen-atom-stream 1\n";
+const char* const AtomStream::MAGIC    = "!ingen-atom-stream 1\n";
+
+AtomStream::AtomStream(URIMap& map)
+	: _map(map)
+	, _atom_Literal(map.map_uri(LV2_ATOM__Literal))
+	, _atom_Object(map.map_uri(LV2_ATOM__Object))
+	, _atom_Sequence(map.map_uri(LV2_ATOM__Sequence))
+	, _atom_Tuple(map.map_uri(LV2_ATOM__Tuple))
+	, _atom_URID(map.map_uri(LV2_ATOM__URID))
+	, _atom_Vector(map.map_uri(LV2_ATOM__Vector))
+{}
+
+AtomStream::Format
+AtomStream::negotiate(int fd, const char* magic, int timeout_ms)
+{
+	typedef std::chrono::steady_clock Clock;
+
+	const Clock::time_point deadline = (
+		Clock::now() + std::chrono::milliseconds(timeout_ms));
+
+	struct pollfd pfd = { fd, POLLIN, 0 };
+	while (true) {
+		const int remaining = (int)std::chrono::duration_cast<
+			std::chrono::milliseconds>(deadline - Clock::now()).count();
+		if (remaining <= 0) {
+			return Format::TURTLE;  // Timeout, peer is not talking
+		}
+
+		const int ret = poll(&pfd, 1, remaining);
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		} else if (ret <= 0 || !(pfd.revents & POLLIN)) {
+			return Format::TURTLE;  // Error, hangup, or timeout
+		}
+
+		const int match = check_magic(fd, magic);
+		if (match) {
+			return match > 0 ? Format::ATOM : Format::TURTLE;
+		}
+
+		// Partial match, wait for the rest to arrive
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+
+int
+AtomStream::check_magic(int fd, const char* magic)
+{
+	// Peek at input without consuming it in case it is Turtle
+	const size_t  len = strlen(magic);
+	char          buf[32];
+	const ssize_t n   = recv(fd, buf, std::min(len, sizeof(buf)),
+	                         MSG_PEEK|MSG_DONTWAIT);
+	if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+		return 0;  // Nothing yet
+	} else if (n <= 0 || strncmp(buf, magic, n)) {
+		return -1;  // Hangup or mismatch
+	} else if ((size_t)n == len) {
+		return recv(fd, buf, len, 0) == (ssize_t)len ? 1 : -1;
+	}
+
+	return 0;  // Partial match
+}
+
+/** Call `visit` with a reference to every URID in `atom`.
+ *
+ * This checks that every child fits in its parent, and that the whole atom
+ * fits before `end`, since the atom may have come from elsewhere.  Zero
+ * URIDs, which mean "none" (e.g. the id of a blank object), are skipped.
+ * Container types are checked after visiting the type, so `visit` may
+ * translate it.
+ */
+template<typename Visit>
+bool
+AtomStream::visit_urids(LV2_Atom* atom, const uint8_t* end, Visit visit)
+{
+	uint8_t* const body     = (uint8_t*)(atom + 1);
+	uint8_t* const body_end = body + atom->size;
+	if (body > end || atom->size > (uint32_t)(end - body)) {
+		return false;
+	} else if (!visit(atom->type)) {
+		return false;
+	}
+
+	if (atom->type == _atom_Object) {
+		LV2_Atom_Object_Body* obj = (LV2_Atom_Object_Body*)body;
+		if (atom->size < sizeof(LV2_Atom_Object_Body) ||
+		    (obj->id && !visit(obj->id)) ||
+		    (obj->otype && !visit(obj->otype))) {
+			return false;
+		}
+
+		uint8_t* p = body + sizeof(LV2_Atom_Object_Body);
+		while (p < body_end) {
+			LV2_Atom_Property_Body* prop = (LV2_Atom_Property_Body*)p;
+			if ((size_t)(body_end - p) < sizeof(LV2_Atom_Property_Body) ||
+			    !visit(prop->key) ||
+			    (prop->context && !visit(prop->context)) ||
+			    !visit_urids(&prop->value, body_end, visit)) {
+				return false;
+			}
+			p += lv2_atom_pad_size(sizeof(LV2_Atom_Property_Body) +
+			                       prop->value.size);
+		}
+	} else if (atom->type == _atom_Tuple) {
+		for (uint8_t* p = body; p < body_end;) {
+			LV2_Atom* child = (LV2_Atom*)p;
+			if (!visit_urids(child, body_end, visit)) {
+				return false;
+			}
+			p += lv2_atom_pad_size(sizeof(LV2_Atom) + child->size);
+		}
+	} else if (atom->type == _atom_Sequence) {
+		LV2_Atom_Sequence_Body* seq = (LV2_Atom_Sequence_Body*)body;
+		if (atom->size < sizeof(LV2_Atom_Sequence_Body) ||
+		    (seq->unit && !visit(seq->unit))) {
+			return false;
+		}
+
+		uint8_t* p = body + sizeof(LV2_Atom_Sequence_Body);
+		while (p < body_end) {
+			LV2_Atom_Event* ev = (LV2_Atom_Event*)p;
+			if ((size_t)(body_end - p) < sizeof(LV2_Atom_Event) ||
+			    !visit_urids(&ev->body, body_end, visit)) {
+				return false;
+			}
+			p += lv2_atom_pad_size(sizeof(LV2_Atom_Event) + ev->body.size);
+		}
+	} else if (atom->type == _atom_Vector) {
+		LV2_Atom_Vector_Body* vec = (LV2_Atom_Vector_Body*)body;
+		if (atom->size < sizeof(LV2_Atom_Vector_Body) ||
+		    !visit(vec->child_type)) {
+			return false;
+		} else if (vec->child_type == _atom_URID) {
+			uint32_t* elems = (uint32_t*)(vec + 1);
+			uint32_t* last  = (uint32_t*)body_end;
+			for (uint32_t* e = elems; e + 1 <= last; ++e) {
+				if (*e && !visit(*e)) {
+					return false;
+				}
+			}
+		}
+	} else if (atom->type == _atom_Literal) {
+		LV2_Atom_Literal_Body* lit = (LV2_Atom_Literal_Body*)body;
+		if (atom->size < sizeof(LV2_Atom_Literal_Body) ||
+		    (lit->datatype && !visit(lit->datatype)) ||
+		    (lit->lang && !visit(lit->lang))) {
+			return false;
+		}
+	} else if (atom->type == _atom_URID) {
+		uint32_t* urid = (uint32_t*)body;
+		if (atom->size < sizeof(uint32_t) || (*urid && !visit(*urid))) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static inline void
+append(std::vector<uint8_t>& out, const void* buf, size_t size)
+{
+	const uint8_t* const bytes = (const uint8_t*)buf;
+	out.insert(out.end(), bytes, bytes + size);
+}
+
+/** Append a frame with the given type and body, padded to 64 bits. */
+static void
+append_frame(std::vector<uint8_t>& out,
+             uint32_t              type,
+             const void*           body1,
+             uint32_t              size1,
+             const void*           body2 = NULL,
+             uint32_t              size2 = 0)
+{
+	const LV2_Atom head = { size1 + size2, type };
+	append(out, &head, sizeof(head));
+	append(out, body1, size1);
+	append(out, body2, size2);
+	out.resize(out.size() + lv2_atom_pad_size(head.size) - head.size, 0);
+}
+
+bool
+AtomStream::write(const LV2_Atom* msg, std::vector<uint8_t>& out)
+{
+	const uint8_t* end  = (const uint8_t*)(msg + 1) + msg->size;
+	const size_t   size = out.size();
+
+	/* Declare any URIDs that have not been sent yet (msg is not modified).
+	   These are only recorded as declared once the whole message is known to
+	   be valid, since nothing is sent otherwise. */
+	std::unordered_set<uint32_t> declared;
+	const bool valid = visit_urids(
+		const_cast<LV2_Atom*>(msg), end, [&](uint32_t& urid) {
+			if (_declared.count(urid) || declared.count(urid)) {
+				return true;
+			}
+
+			const char* const uri = _map.unmap_uri(urid);
+			if (!uri) {
+				return false;
+			}
+
+			append_frame(out, 0, &urid, sizeof(urid), uri, strlen(uri) + 1);
+			declared.insert(urid);
+			return true;
+		});
+
+	if (!valid) {
+		out.resize(size);  // Remove any declarations for this message
+		return false;
+	}
+
+	append_frame(out, msg->type, msg + 1, msg->size);
+	_declared.insert(declared.begin(), declared.end());
+	return true;
+}
+
+bool
+AtomStream::read(LV2_Atom* frame, uint32_t size)
+{
+	const uint8_t* const end = (const uint8_t*)frame + size;
+	if (size < sizeof(LV2_Atom)) {
+		return false;
+	} else if (frame->type == 0) {
+		// Declaration of a remote URID
+		const uint32_t* const urid = (const uint32_t*)(frame + 1);
+		const char* const     uri  = (const char*)(urid + 1);
+		if (frame->size <= sizeof(uint32_t) ||
+		    frame->size > size - sizeof(LV2_Atom) ||
+		    uri[frame->size - sizeof(uint32_t) - 1] != '\0') {
+			return false;
+		}
+
+		_urids[*urid] = _map.map_uri(uri);
+		return false;
+	}
+
+	// Message, translate remote URIDs to local ones
+	return visit_urids(frame, end, [&](uint32_t& urid) {
+			const auto u = _urids.find(urid);
+			if (u == _urids.end()) {
+				return false;
+			}
+			urid = u->second;
+			return true;
+		});
+}
+
+}  // namespace Ingen
@@ -64,16 +64,6 @@ AtomWriter::finish_msg()
 	_out.len = 0;
 }
 
-void
-AtomWriter::bundle_begin()
-{
-}
-
-void
-AtomWriter::bundle_end()
-{
-}
-
 void
 AtomWriter::forge_uri(const Raul::URI& uri)
 {
@@ -333,16 +323,24 @@ void
 AtomWriter::set_property(const Raul::URI& subject,
                          const Raul::URI& predicate,
                          const Atom&      value)
+{
+	set_property(subject, _map.map_uri(predicate.c_str()), value.atom());
+}
+
+void
+AtomWriter::set_property(const Raul::URI& subject,
+                         LV2_URID         predicate,
+                         const LV2_Atom*  value)
 {
 	LV2_Atom_Forge_Frame msg;
 	forge_request(&msg, _uris.patch_Set);
 	lv2_atom_forge_key(&_forge, _uris.patch_subject);
 	forge_uri(subject);
 	lv2_atom_forge_key(&_forge, _uris.patch_property);
-	lv2_atom_forge_urid(&_forge, _map.map_uri(predicate.c_str()));
+	lv2_atom_forge_urid(&_forge, predicate);
 	lv2_atom_forge_key(&_forge, _uris.patch_value);
-	lv2_atom_forge_atom(&_forge, value.size(), value.type());
-	lv2_atom_forge_write(&_forge, value.get_body(), value.size());
+	lv2_atom_forge_atom(&_forge, value->size, value->type);
+	lv2_atom_forge_write(&_forge, LV2_ATOM_BODY_CONST(value), value->size);
 
 	lv2_atom_forge_pop(&_forge, &msg);
 	finish_msg();
@@ -477,6 +475,57 @@ AtomWriter::disconnect_all(const Raul::Path& graph,
 	finish_msg();
 }
 
+/** @page protocol
+ * @subsection Bundles Atomic Bundles
+ *
+ * A sequence of messages can be applied atomically by surrounding it with an
+ * ingen:BundleStart and an ingen:BundleEnd.  The engine waits until every
+ * message in the bundle has been prepared, then applies them all in the same
+ * process cycle, so the audio thread never runs a partially edited graph.
+ * Each graph modified by the bundle is compiled only once, at the end, which
+ * makes loading or pasting many blocks and arcs much cheaper.
+ *
+ * Bundles may be nested, in which case only the outermost bundle has any
+ * effect.
+ *
+ * @code{.ttl}
+ * [] a ingen:BundleStart .
+ * []
+ *     a patch:Put ;
+ *     patch:subject </graph/osc> ;
+ *     patch:body [
+ *         a ingen:Block ;
+ *         lv2:prototype <http://drobilla.net/plugins/mda/Shepard>
+ *     ] .
+ * []
+ *     a patch:Put ;
+ *     patch:subject </graph/> ;
+ *     patch:body [
+ *         a ingen:Arc ;
+ *         ingen:tail </graph/osc/out> ;
+ *         ingen:head </graph/audio_out>
+ *     ] .
+ * [] a ingen:BundleEnd .
+ * @endcode
+ */
+void
+AtomWriter::bundle_begin()
+{
+	LV2_Atom_Forge_Frame msg;
+	forge_request(&msg, _uris.ingen_BundleStart);
+	lv2_atom_forge_pop(&_forge, &msg);
+	finish_msg();
+}
+
+void
+AtomWriter::bundle_end()
+{
+	LV2_Atom_Forge_Frame msg;
+	forge_request(&msg, _uris.ingen_BundleEnd);
+	lv2_atom_forge_pop(&_forge, &msg);
+	finish_msg();
+}
+
 void
 AtomWriter::set_response_id(int32_t id)
 {
@@ -63,7 +63,18 @@ Configuration::Configuration(Forge& forge)
 	add("save",           "save",           'o', "Save graph", SESSION, forge.String, Atom());
 	add("execute",        "execute",        'x', "File of commands to execute", SESSION, forge.String, Atom());
 	add("path",           "path",           'L', "Target path for loaded graph", SESSION, forge.String, Atom());
+	add("render",         "render",          0,  "Render to files in directory instead of running with JACK", SESSION, forge.String, Atom());
+	add("renderInput",    "render-input",    0,  "Directory of input files for rendering", SESSION, forge.String, Atom());
+	add("renderLength",   "render-length",   0,  "Number of frames to render (default: length of inputs)", SESSION, forge.Int, forge.make(0));
+	add("renderRate",     "render-rate",     0,  "Sample rate for rendering", SESSION, forge.Int, forge.make(48000));
+	add("renderBlock",    "render-block",    0,  "Block length for rendering", SESSION, forge.Int, forge.make(1024));
 	add("queueSize",      "queue-size",     'q', "Event queue size", GLOBAL, forge.Int, forge.make(4096));
+	add("threads",        "threads",        't', "Number of processing threads", GLOBAL, forge.Int, forge.make(1));
+	add("eventBudget",    "event-budget",    0,  "Percentage of each cycle to spend executing events", GLOBAL, forge.Int, forge.make(5));
+	add("preThreads",     "pre-threads",     0,  "Number of threads for preparing independent events concurrently", GLOBAL, forge.Int, forge.make(0));
+	add("levelSchedule",  "level-schedule",  0,  "Run graphs in parallel level by level", GLOBAL, forge.Bool, forge.make(false));
+	add("voiceParallel",  "voice-parallel",  0,  "Run voices of polyphonic graphs in parallel", GLOBAL, forge.Bool, forge.make(false));
+	add("profile",        "profile",         0,  "Measure and broadcast the DSP load of blocks", GLOBAL, forge.Bool, forge.make(false));
 	add("flushLog",       "flush-log",      'f', "Flush logs after every entry", SESSION, forge.Bool, forge.make(false));
 	add("humanNames",     "human-names",     0,  "Show human names in GUI", GUI, forge.Bool, forge.make(true));
 	add("portLabels",     "port-labels",     0,  "Show port labels in GUI", GUI, forge.Bool, forge.make(true));
@@ -690,10 +690,13 @@ Parser::parse_file(Ingen::World*                     world,
 	if (symbol)
 		world->log().info(fmt("Symbol: %1%\n") % symbol->c_str());
 
+	// Load everything in one bundle so each graph is only compiled once
+	target->bundle_begin();
 	Sord::Node subject(*world->rdf_world(), Sord::Node::URI, uri);
 	boost::optional<Raul::Path> parsed_path
 		= parse(world, target, model, model.base_uri().to_string(),
 		        subject, parent, symbol, data);
+	target->bundle_end();
 
 	if (parsed_path) {
 		target->set_property(Node::path_to_uri(*parsed_path),
@@ -732,7 +735,9 @@ Parser::parse_string(Ingen::World*                     world,
 	world->log().info(fmt("Parsing string (base %1%)\n") % base_uri);
 
 	Sord::Node subject;
+	target->bundle_begin();
 	parse(world, target, model, actual_base, subject, parent, symbol, data);
+	target->bundle_end();
 	return actual_base;
 }
 
@@ -14,31 +14,98 @@
   along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <utility>
 
 #include "ingen/Atom.hpp"
+#include "ingen/Forge.hpp"
 #include "ingen/Resource.hpp"
+#include "ingen/URIMap.hpp"
 #include "ingen/URIs.hpp"
 
 using namespace std;
 
 namespace Ingen {
 
+Resource::PropertyTable&
+Resource::PropertyTable::operator=(const PropertyTable& copy)
+{
+	if (&copy != this) {
+		std::vector<Entry> entries;
+		entries.reserve(copy._entries.size());
+		for (const auto& e : copy._entries) {
+			entries.push_back(
+				Entry{e.key, std::unique_ptr<Property>(new Property(*e.value))});
+		}
+		_entries = std::move(entries);
+	}
+	return *this;
+}
+
+static bool
+key_less(const Resource::PropertyTable::Entry& e, LV2_URID key)
+{
+	return e.key < key;
+}
+
+static bool
+less_key(LV2_URID key, const Resource::PropertyTable::Entry& e)
+{
+	return key < e.key;
+}
+
+std::pair<Resource::PropertyTable::iterator, Resource::PropertyTable::iterator>
+Resource::PropertyTable::equal_range(LV2_URID key)
+{
+	iterator first = std::lower_bound(begin(), end(), key, key_less);
+	return std::make_pair(first, std::upper_bound(first, end(), key, less_key));
+}
+
+std::pair<Resource::PropertyTable::const_iterator,
+          Resource::PropertyTable::const_iterator>
+Resource::PropertyTable::equal_range(LV2_URID key) const
+{
+	const_iterator first = std::lower_bound(begin(), end(), key, key_less);
+	return std::make_pair(first, std::upper_bound(first, end(), key, less_key));
+}
+
+Resource::Property&
+Resource::PropertyTable::insert(LV2_URID key, const Property& value)
+{
+	iterator i = std::upper_bound(begin(), end(), key, less_key);
+	i = _entries.insert(
+		i, Entry{key, std::unique_ptr<Property>(new Property(value))});
+	return *i->value;
+}
+
+LV2_URID
+Resource::key(const Raul::URI& uri) const
+{
+	return _uris.forge.uri_map().map_uri(uri.c_str());
+}
+
+Raul::URI
+Resource::key_uri(LV2_URID key) const
+{
+	return Raul::URI(_uris.forge.uri_map().unmap_uri(key));
+}
+
 void
 Resource::add_property(const Raul::URI& uri,
                        const Atom&      value,
                        Graph            ctx)
 {
 	// Ignore duplicate statements
-	typedef Resource::Properties::const_iterator iterator;
-	const std::pair<iterator, iterator> range = _properties.equal_range(uri);
-	for (iterator i = range.first; i != range.second && i != _properties.end(); ++i) {
-		if (i->second == value && i->second.context() == ctx) {
+	typedef PropertyTable::const_iterator iterator;
+	const LV2_URID                      k     = key(uri);
+	const std::pair<iterator, iterator> range = _properties.equal_range(k);
+	for (iterator i = range.first; i != range.second; ++i) {
+		if (*i->value == value && i->value->context() == ctx) {
 			return;
 		}
 	}
 
-	const Atom& v = _properties.insert(make_pair(uri, Property(value, ctx)))->second;
+	const Atom& v = _properties.insert(k, Property(value, ctx));
 	on_property(uri, v);
 }
 
@@ -47,21 +114,37 @@ Resource::set_property(const Raul::URI& uri,
                        const Atom&      value,
                        Resource::Graph  ctx)
 {
-	// Erase existing property in this context
-	for (Properties::iterator i = _properties.find(uri);
-	     (i != _properties.end()) && (i->first == uri);) {
-		Properties::iterator next = i;
-		++next;
-		if (i->second.context() == ctx) {
-			const Atom value(i->second);
-			_properties.erase(i);
-			on_property_removed(uri, value);
+	/* Erase existing properties in this context, except the first which is
+	   reused for the new value.  This avoids reallocating the value for the
+	   common case of repeatedly setting a single-valued property like
+	   ingen:value, and keeps references to it valid. */
+	const LV2_URID k    = key(uri);
+	Property*      slot = NULL;
+	for (PropertyTable::iterator i = _properties.equal_range(k).first;
+	     i != _properties.end() && i->key == k;) {
+		if (i->value->context() == ctx) {
+			if (!slot) {
+				slot = i->value.get();
+			} else {
+				const Atom old(*i->value);
+				i = _properties.erase(i);
+				on_property_removed(uri, old);
+				continue;
+			}
 		}
-		i = next;
+		++i;
+	}
+
+	if (slot) {
+		const Atom old(*slot);
+		static_cast<Atom&>(*slot) = value;
+		on_property_removed(uri, old);
+		on_property(uri, *slot);
+		return *slot;
 	}
 
 	// Insert new property
-	const Atom& v = _properties.insert(make_pair(uri, Property(value, ctx)))->second;
+	const Atom& v = _properties.insert(k, Property(value, ctx));
 	on_property(uri, v);
 	return v;
 }
@@ -77,13 +160,13 @@ Resource::set_property(const Raul::URI&   uri,
 void
 Resource::remove_property(const Raul::URI& uri, const Atom& value)
 {
+	typedef PropertyTable::iterator iterator;
+	const std::pair<iterator, iterator> range = _properties.equal_range(key(uri));
 	if (_uris.patch_wildcard == value) {
-		_properties.erase(uri);
+		_properties.erase(range.first, range.second);
 	} else {
-		for (Properties::iterator i = _properties.find(uri);
-		     i != _properties.end() && (i->first == uri);
-		     ++i) {
-			if (i->second == value) {
+		for (iterator i = range.first; i != range.second; ++i) {
+			if (*i->value == value) {
 				_properties.erase(i);
 				break;
 			}
@@ -102,9 +185,10 @@ Resource::remove_property(const Raul::URI& uri, const URIs::Quark& value)
 bool
 Resource::has_property(const Raul::URI& uri, const Atom& value) const
 {
-	Properties::const_iterator i = _properties.find(uri);
-	for (; (i != _properties.end()) && (i->first == uri); ++i) {
-		if (i->second == value) {
+	typedef PropertyTable::const_iterator iterator;
+	const std::pair<iterator, iterator> range = _properties.equal_range(key(uri));
+	for (iterator i = range.first; i != range.second; ++i) {
+		if (*i->value == value) {
 			return true;
 		}
 	}
@@ -114,9 +198,10 @@ Resource::has_property(const Raul::URI& uri, const Atom& value) const
 bool
 Resource::has_property(const Raul::URI& uri, const URIs::Quark& value) const
 {
-	Properties::const_iterator i = _properties.find(uri);
-	for (; (i != _properties.end()) && (i->first == uri); ++i) {
-		if (value == i->second) {
+	typedef PropertyTable::const_iterator iterator;
+	const std::pair<iterator, iterator> range = _properties.equal_range(key(uri));
+	for (iterator i = range.first; i != range.second; ++i) {
+		if (value == *i->value) {
 			return true;
 		}
 	}
@@ -133,8 +218,9 @@ const Atom&
 Resource::get_property(const Raul::URI& uri) const
 {
 	static const Atom nil;
-	Properties::const_iterator i = _properties.find(uri);
-	return (i != _properties.end()) ? i->second : nil;
+	typedef PropertyTable::const_iterator iterator;
+	const std::pair<iterator, iterator> range = _properties.equal_range(key(uri));
+	return (range.first != range.second) ? *range.first->value : nil;
 }
 
 bool
@@ -190,7 +276,8 @@ Resource::set_properties(const Properties& props)
 
 	// Erase existing properties with matching keys
 	for (const auto& p : props) {
-		_properties.erase(p.first);
+		const auto range = _properties.equal_range(key(p.first));
+		_properties.erase(range.first, range.second);
 		on_property_removed(p.first, _uris.patch_wildcard.urid);
 	}
 
@@ -212,6 +299,17 @@ Resource::remove_properties(const Properties& props)
 		remove_property(p.first, p.second);
 }
 
+Resource::Properties
+Resource::properties() const
+{
+	Properties props;
+	for (const auto& e : _properties) {
+		props.emplace(key_uri(e.key), *e.value);
+	}
+
+	return props;
+}
+
 Resource::Properties
 Resource::properties(Resource::Graph ctx) const
 {
@@ -220,10 +318,10 @@ Resource::properties(Resource::Graph ctx) const
 	}
 
 	Properties props;
-	for (const auto& p : _properties) {
-		if (p.second.context() == Resource::Graph::DEFAULT
-		    || p.second.context() == ctx) {
-			props.insert(make_pair(p.first, p.second));
+	for (const auto& e : _properties) {
+		if (e.value->context() == Resource::Graph::DEFAULT
+		    || e.value->context() == ctx) {
+			props.emplace(key_uri(e.key), *e.value);
 		}
 	}
 
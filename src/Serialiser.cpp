@@ -342,7 +342,7 @@ Serialiser::Impl::serialise_graph(SPtr<const Node>  graph,
 	                      Sord::URI(world, "http://drobilla.net/ns/ingen#GraphUIGtk2"));
 
 	// If the graph has no doap:name (required by LV2), use the symbol
-	if (graph->properties().find(uris.doap_name) == graph->properties().end()) {
+	if (!graph->get_property(uris.doap_name).is_valid()) {
 		std::string sym = Glib::path_get_basename(graph_id.to_string());
 		sym = sym.substr(0, sym.find('.'));
 		_model->add_statement(graph_id,
@@ -412,7 +412,7 @@ Serialiser::Impl::serialise_graph(SPtr<const Node>  graph,
 		const Sord::Node port_id = path_rdf_node(p->path());
 
 		// Ensure lv2:name always exists so Graph is a valid LV2 plugin
-		if (p->properties().find(uris.lv2_name) == p->properties().end())
+		if (!p->get_property(uris.lv2_name).is_valid())
 			p->set_property(uris.lv2_name,
 			                _world.forge().alloc(p->symbol().c_str()));
 
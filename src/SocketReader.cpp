@@ -16,6 +16,12 @@
 
 #include <errno.h>
 #include <poll.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include <vector>
 
 #include "ingen/AtomReader.hpp"
 #include "ingen/Interface.hpp"
@@ -23,6 +29,7 @@
 #include "ingen/SocketReader.hpp"
 #include "ingen/URIMap.hpp"
 #include "ingen/World.hpp"
+#include "lv2/lv2plug.in/ns/ext/atom/util.h"
 #include "sord/sordmm.hpp"
 #include "sratom/sratom.h"
 
@@ -30,12 +37,16 @@ namespace Ingen {
 
 SocketReader::SocketReader(Ingen::World&      world,
                            Interface&         iface,
-                           SPtr<Raul::Socket> sock)
+                           SPtr<Raul::Socket> sock,
+                           AtomStream::Format format)
 	: _world(world)
 	, _iface(iface)
+	, _rdf_world(NULL)
+	, _env(NULL)
 	, _inserter(NULL)
 	, _msg_node(NULL)
 	, _socket(sock)
+	, _format(format)
 	, _exit_flag(false)
 	, _thread(&SocketReader::run, this)
 {}
@@ -74,7 +85,7 @@ SocketReader::write_statement(SocketReader*      iface,
 {
 	if (!iface->_msg_node) {
 		iface->_msg_node = sord_node_from_serd_node(
-			iface->_world.rdf_world()->c_obj(), iface->_env, subject, 0, 0);
+			iface->_rdf_world, iface->_env, subject, 0, 0);
 	}
 
 	return sord_inserter_write_statement(
@@ -83,19 +94,100 @@ SocketReader::write_statement(SocketReader*      iface,
 		object_datatype, object_lang);
 }
 
+/** Receive exactly `len` bytes into `buf`. */
+static bool
+recv_all(int fd, void* buf, size_t len)
+{
+	uint8_t* p = (uint8_t*)buf;
+	while (len > 0) {
+		const ssize_t ret = recv(fd, p, len, MSG_WAITALL);
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		} else if (ret <= 0) {
+			return false;
+		}
+		p   += ret;
+		len -= ret;
+	}
+	return true;
+}
+
+void
+SocketReader::run_atoms()
+{
+	AtomStream stream(_world.uri_map());
+
+	// Make an AtomReader to call Ingen Interface methods based on Atom
+	AtomReader ar(_world.uri_map(),
+	              _world.uris(),
+	              _world.log(),
+	              _world.forge(),
+	              _iface);
+
+	struct pollfd pfd;
+	pfd.fd      = _socket->fd();
+	pfd.events  = POLLIN;
+	pfd.revents = 0;
+
+	std::vector<uint64_t> buf;  // 64-bit aligned frame
+	while (!_exit_flag) {
+		// Wait for input to arrive at socket
+		int ret = poll(&pfd, 1, -1);
+		if (ret == -1 || (pfd.revents & (POLLERR|POLLHUP|POLLNVAL))) {
+			on_hangup();
+			break;  // Hangup
+		} else if (!ret) {
+			continue;  // No data, shouldn't happen
+		}
+
+		// Read frame header, then the rest of the frame
+		LV2_Atom head;
+		if (!recv_all(pfd.fd, &head, sizeof(head))) {
+			on_hangup();
+			break;
+		} else if (head.size > AtomStream::MAX_FRAME_SIZE) {
+			_world.log().error(fmt("Message too large (%1% bytes)\n")
+			                   % head.size);
+			on_hangup();
+			break;
+		}
+
+		const uint32_t size = sizeof(LV2_Atom) + lv2_atom_pad_size(head.size);
+		buf.resize(size / sizeof(uint64_t));
+		memcpy(buf.data(), &head, sizeof(head));
+		if (!recv_all(pfd.fd, buf.data() + 1, size - sizeof(head))) {
+			on_hangup();
+			break;
+		}
+
+		// Translate URIDs and call _iface methods based on atom content
+		LV2_Atom* const frame = (LV2_Atom*)buf.data();
+		if (stream.read(frame, size)) {
+			ar.write(frame);
+		} else if (frame->type) {
+			_world.log().error("Invalid message\n");
+		}
+	}
+}
+
 void
 SocketReader::run()
 {
-	Sord::World*  world = _world.rdf_world();
-	LV2_URID_Map* map   = &_world.uri_map().urid_map_feature()->urid_map;
+	if (_format == AtomStream::Format::ATOM) {
+		run_atoms();
+		return;
+	}
+
+	LV2_URID_Map* map = &_world.uri_map().urid_map_feature()->urid_map;
 
-	// Open socket as a FILE for reading directly with serd
-	FILE* f = fdopen(_socket->fd(), "r");
+	// Open socket as a FILE for reading directly with serd.  This uses a
+	// duplicate descriptor, so closing the FILE leaves the socket to its owner.
+	FILE* f = fdopen(dup(_socket->fd()), "r");
 	if (!f) {
 		_world.log().error(fmt("Failed to open connection (%1%)\n")
 		                   % strerror(errno));
 		// Connection gone, exit
-		_socket.reset();
+		on_hangup();
 		return;
 	}
 
@@ -107,22 +199,26 @@ SocketReader::run()
 	lv2_atom_forge_set_sink(
 		&forge, sratom_forge_sink, sratom_forge_deref, &chunk);
 
-	SordNode*  base_uri = NULL;
-	SordModel* model    = NULL;
+	// Parse in a private RDF world and environment, so connections do not
+	// contend with each other or the rest of Ingen for the shared world
+	_rdf_world = sord_world_new();
+	_env       = serd_env_new(NULL);
 	{
-		// Lock RDF world
+		// Lock RDF world to copy the shared prefixes
 		std::lock_guard<std::mutex> lock(_world.rdf_mutex());
+		serd_env_foreach(_world.rdf_world()->prefixes().c_obj(),
+		                 (SerdPrefixSink)serd_env_set_prefix,
+		                 _env);
+	}
 
-		// Use <ingen:/> as base URI, so relative URIs are like bundle paths
-		base_uri = sord_new_uri(world->c_obj(), (const uint8_t*)"ingen:/");
+	// Use <ingen:/> as base URI, so relative URIs are like bundle paths
+	SordNode* base_uri = sord_new_uri(_rdf_world, (const uint8_t*)"ingen:/");
 
-		// Make a model and reader to parse the next Turtle message
-		_env = world->prefixes().c_obj();
-		model = sord_new(world->c_obj(), SORD_SPO, false);
+	// Make a model and reader to parse the next Turtle message
+	SordModel* model = sord_new(_rdf_world, SORD_SPO, false);
 
-		// Create an inserter for writing incoming triples to model
-		_inserter = sord_inserter_new(model, _env);
-	}
+	// Create an inserter for writing incoming triples to model
+	_inserter = sord_inserter_new(model, _env);
 
 	SerdReader* reader = serd_reader_new(
 		SERD_TURTLE, this, NULL,
@@ -148,6 +244,7 @@ SocketReader::run()
 
 	while (!_exit_flag) {
 		if (feof(f)) {
+			on_hangup();
 			break;  // Lost connection
 		}
 
@@ -160,9 +257,6 @@ SocketReader::run()
 			continue;  // No data, shouldn't happen
 		}
 
-		// Lock RDF world
-		std::lock_guard<std::mutex> lock(_world.rdf_mutex());
-
 		// Read until the next '.'
 		SerdStatus st = serd_reader_read_chunk(reader);
 		if (st == SERD_FAILURE || !_msg_node) {
@@ -174,20 +268,17 @@ SocketReader::run()
 		}
 
 		// Build an LV2_Atom at chunk.buf from the message
-		sratom_read(sratom, &forge, world->c_obj(), model, _msg_node);
+		sratom_read(sratom, &forge, _rdf_world, model, _msg_node);
 
 		// Call _iface methods based on atom content
 		ar.write((const LV2_Atom*)chunk.buf);
 
 		// Reset everything for the next iteration
 		chunk.len = 0;
-		sord_node_free(world->c_obj(), _msg_node);
+		sord_node_free(_rdf_world, _msg_node);
 		_msg_node = NULL;
 	}
 
-	// Lock RDF world
-	std::lock_guard<std::mutex> lock(_world.rdf_mutex());
-
 	// Destroy everything
 	fclose(f);
 	sord_inserter_free(_inserter);
@@ -195,8 +286,10 @@ SocketReader::run()
 	sratom_free(sratom);
 	serd_reader_free(reader);
 	sord_free(model);
+	sord_node_free(_rdf_world, base_uri);
+	serd_env_free(_env);
+	sord_world_free(_rdf_world);
 	free((uint8_t*)chunk.buf);
-	_socket.reset();
 }
 
 }  // namespace Ingen
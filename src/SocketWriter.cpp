@@ -33,11 +33,7 @@ static size_t
 socket_sink(const void* buf, size_t len, void* stream)
 {
 	SocketWriter* writer = (SocketWriter*)stream;
-	ssize_t       ret    = send(writer->fd(), buf, len, MSG_NOSIGNAL);
-	if (ret < 0) {
-		return 0;
-	}
-	return ret;
+	return writer->write_bytes(buf, len) ? len : 0;
 }
 
 static SerdStatus
@@ -51,9 +47,13 @@ write_prefix(void* handle, const SerdNode* name, const SerdNode* uri)
 SocketWriter::SocketWriter(URIMap&            map,
                            URIs&              uris,
                            const Raul::URI&   uri,
-                           SPtr<Raul::Socket> sock)
+                           SPtr<Raul::Socket> sock,
+                           AtomStream::Format format)
 	: AtomWriter(map, uris, *this)
 	, _map(map)
+	, _uris(uris)
+	, _format(format)
+	, _stream(map)
 	, _sratom(sratom_new(&map.urid_map_feature()->urid_map))
 	, _uri(uri)
 	, _socket(sock)
@@ -86,7 +86,9 @@ SocketWriter::SocketWriter(URIMap&            map,
 		this);
 
 	// Write namespace prefixes to reduce traffic
-	serd_env_foreach(_env, write_prefix, this);
+	if (_format == AtomStream::Format::TURTLE) {
+		serd_env_foreach(_env, write_prefix, this);
+	}
 
 	// Configure sratom to write directly to the writer (and thus the socket)
 	sratom_set_sink(_sratom,
@@ -106,20 +108,43 @@ SocketWriter::~SocketWriter()
 bool
 SocketWriter::write(const LV2_Atom* msg)
 {
+	if (_format == AtomStream::Format::ATOM) {
+		// Send atom directly, with any new URIDs it uses declared first
+		_buf.clear();
+		return (_stream.write(msg, _buf) &&
+		        write_bytes(_buf.data(), _buf.size()));
+	}
+
 	sratom_write(_sratom, &_map.urid_unmap_feature()->urid_unmap, 0,
 	             NULL, NULL, msg->type, msg->size, LV2_ATOM_BODY_CONST(msg));
 	serd_writer_finish(_writer);
+
+	if (msg->type == _uris.atom_Object &&
+	    ((const LV2_Atom_Object*)msg)->body.otype == _uris.ingen_BundleEnd) {
+		// Send a NULL byte to indicate end of bundle
+		const char end[] = { 0 };
+		return write_bytes(end, 1);
+	}
+
 	return true;
 }
 
-void
-SocketWriter::bundle_end()
+bool
+SocketWriter::write_bytes(const void* buf, size_t len)
 {
-	AtomWriter::bundle_end();
-
-	// Send a NULL byte to indicate end of bundle
-	const char end[] = { 0 };
-	send(fd(), end, 1, MSG_NOSIGNAL);
+	// Send all of buf, which send() may not do in one go
+	const uint8_t* bytes = (const uint8_t*)buf;
+	while (len > 0) {
+		const ssize_t ret = send(fd(), bytes, len, MSG_NOSIGNAL);
+		if (ret < 0 && errno == EINTR) {
+			continue;
+		} else if (ret <= 0) {
+			return false;
+		}
+		bytes += ret;
+		len   -= ret;
+	}
+	return true;
 }
 
 } // namespace Ingen
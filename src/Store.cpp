@@ -22,6 +22,74 @@ using namespace std;
 
 namespace Ingen {
 
+Store::iterator
+Store::find(const Raul::Path& path)
+{
+	const Index::const_iterator i = _index.find(&path);
+	return (i == _index.end()) ? end() : i->second;
+}
+
+Store::const_iterator
+Store::find(const Raul::Path& path) const
+{
+	const Index::const_iterator i = _index.find(&path);
+	return (i == _index.end()) ? end() : const_iterator(i->second);
+}
+
+std::pair<Store::iterator, bool>
+Store::insert(const value_type& value)
+{
+	const std::pair<iterator, bool> r = Base::insert(value);
+	if (r.second) {
+		_index.insert(make_pair(&r.first->first, r.first));
+		++_generation;
+	}
+	return r;
+}
+
+SPtr<Node>&
+Store::operator[](const Raul::Path& path)
+{
+	return insert(make_pair(path, SPtr<Node>())).first->second;
+}
+
+void
+Store::erase(const iterator i)
+{
+	_index.erase(&i->first);
+	Base::erase(i);
+	++_generation;
+}
+
+void
+Store::erase(const iterator first, const iterator last)
+{
+	for (iterator i = first; i != last; ++i) {
+		_index.erase(&i->first);
+	}
+	Base::erase(first, last);
+	++_generation;
+}
+
+Store::size_type
+Store::erase(const Raul::Path& path)
+{
+	const iterator i = find(path);
+	if (i == end()) {
+		return 0;
+	}
+	erase(i);
+	return 1;
+}
+
+void
+Store::clear()
+{
+	_index.clear();
+	Base::clear();
+	++_generation;
+}
+
 void
 Store::add(Node* o)
 {
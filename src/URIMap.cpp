@@ -15,8 +15,12 @@
 */
 
 #include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
 
-#include <glib.h>
+#include <atomic>
+#include <mutex>
+#include <vector>
 
 #include "ingen/URIMap.hpp"
 
@@ -24,6 +28,193 @@ using namespace std;
 
 namespace Ingen {
 
+namespace {
+
+/** Process-wide table of URIs used for the default URID map.
+ *
+ * Like the GQuarks this replaces, URIDs are allocated sequentially from 1
+ * and are never freed, so unmapped strings are valid forever.
+ *
+ * Looking up a URI that is already mapped, and unmapping, are lock-free.
+ * URIs are hashed into several shards, each an open-addressed hash table, and
+ * inserting a new URI only locks its shard.  Tables are grown by replacing
+ * them, and a reader that misses an entry in an old table finds it when
+ * retrying under the lock.
+ */
+class URITable {
+public:
+	URITable() : _next(1) {
+		for (size_t b = 0; b < N_BUCKETS; ++b) {
+			_buckets[b].store(NULL, std::memory_order_relaxed);
+		}
+		for (size_t s = 0; s < N_SHARDS; ++s) {
+			_shards[s].slots.store(new Slots(64), std::memory_order_relaxed);
+			_shards[s].count = 0;
+		}
+	}
+
+	/** Return the URID of `uri`, or zero if it is not mapped. */
+	LV2_URID find(const char* uri) const {
+		const uint32_t hash = hash_uri(uri);
+		const Shard&   shard = _shards[hash >> (32 - SHARD_BITS)];
+		return probe(shard.slots.load(std::memory_order_acquire), hash, uri);
+	}
+
+	/** Return the URID of `uri`, mapping it if necessary. */
+	LV2_URID map(const char* uri) {
+		const uint32_t hash  = hash_uri(uri);
+		Shard&         shard = _shards[hash >> (32 - SHARD_BITS)];
+		LV2_URID       urid  = probe(
+			shard.slots.load(std::memory_order_acquire), hash, uri);
+		if (urid) {
+			return urid;
+		}
+
+		std::lock_guard<std::mutex> lock(shard.mutex);
+		Slots* slots = shard.slots.load(std::memory_order_relaxed);
+		if ((urid = probe(slots, hash, uri))) {
+			return urid;  // Mapped by another thread since the lookup above
+		}
+
+		// Publish string before the slot so readers that find it can unmap it
+		const size_t len = strlen(uri);
+		char* const  str = (char*)malloc(len + 1);
+		memcpy(str, uri, len + 1);
+		urid = _next.fetch_add(1, std::memory_order_relaxed);
+		entry(urid, true)->store(str, std::memory_order_release);
+
+		// Keep the table at most half full
+		if ((shard.count + 1) * 2 > slots->size) {
+			Slots* const grown = new Slots(slots->size * 2);
+			for (size_t i = 0; i < slots->size; ++i) {
+				const uint64_t slot = slots->slots[i].load(
+					std::memory_order_relaxed);
+				if (slot) {
+					grown->insert(slot);
+				}
+			}
+			shard.slots.store(grown, std::memory_order_release);
+			shard.retired.push_back(slots);  // May still be read
+			slots = grown;
+		}
+
+		slots->insert((uint64_t(hash) << 32) | urid);
+		++shard.count;
+		return urid;
+	}
+
+	/** Return the URI mapped to `urid`, or NULL. */
+	const char* unmap(LV2_URID urid) const {
+		std::atomic<const char*>* const e = entry(urid, false);
+		return e ? e->load(std::memory_order_acquire) : NULL;
+	}
+
+private:
+	static const size_t SHARD_BITS  = 6;
+	static const size_t N_SHARDS    = 1 << SHARD_BITS;
+	static const size_t BUCKET_BITS = 6;  ///< Log2 of first bucket size
+	static const size_t N_BUCKETS   = 33 - BUCKET_BITS;
+
+	/** Open-addressed hash table of (hash << 32 | urid), zero if empty. */
+	struct Slots {
+		explicit Slots(size_t n) : size(n), slots(new std::atomic<uint64_t>[n]) {
+			for (size_t i = 0; i < n; ++i) {
+				slots[i].store(0, std::memory_order_relaxed);
+			}
+		}
+
+		void insert(uint64_t slot) {
+			const size_t mask = size - 1;
+			size_t       i    = (slot >> 32) & mask;
+			while (slots[i].load(std::memory_order_relaxed)) {
+				i = (i + 1) & mask;
+			}
+			slots[i].store(slot, std::memory_order_release);
+		}
+
+		const size_t                 size;
+		std::atomic<uint64_t>* const slots;
+	};
+
+	struct Shard {
+		std::mutex          mutex;
+		std::atomic<Slots*> slots;
+		size_t              count;
+		std::vector<Slots*> retired;
+	};
+
+	static uint32_t hash_uri(const char* uri) {
+		uint32_t hash = 2166136261u;  // FNV-1a
+		for (const char* c = uri; *c; ++c) {
+			hash = (hash ^ (uint8_t)*c) * 16777619u;
+		}
+		return hash;
+	}
+
+	LV2_URID probe(const Slots* slots, uint32_t hash, const char* uri) const {
+		const size_t mask = slots->size - 1;
+		for (size_t i = hash & mask;; i = (i + 1) & mask) {
+			const uint64_t slot = slots->slots[i].load(std::memory_order_acquire);
+			if (!slot) {
+				return 0;
+			} else if ((slot >> 32) == hash) {
+				const LV2_URID urid = slot & 0xFFFFFFFF;
+				if (!strcmp(unmap(urid), uri)) {
+					return urid;
+				}
+			}
+		}
+	}
+
+	/** Return the unmap entry for `urid`, allocating its bucket if `create`.
+	 *
+	 * Entries are stored in buckets that double in size, so they never move.
+	 */
+	std::atomic<const char*>* entry(LV2_URID urid, bool create) const {
+		if (urid == 0) {
+			return NULL;
+		}
+
+		const uint64_t n      = uint64_t(urid) - 1 + (1 << BUCKET_BITS);
+		const unsigned msb    = 63 - __builtin_clzll(n);
+		const size_t   b      = msb - BUCKET_BITS;
+		const size_t   offset = n - (uint64_t(1) << msb);
+
+		std::atomic<const char*>* bucket = _buckets[b].load(
+			std::memory_order_acquire);
+		if (!bucket && create) {
+			const size_t size = size_t(1) << msb;
+			bucket = new std::atomic<const char*>[size];
+			for (size_t i = 0; i < size; ++i) {
+				bucket[i].store(NULL, std::memory_order_relaxed);
+			}
+
+			// Another shard may be allocating the same bucket
+			std::atomic<const char*>* expected = NULL;
+			if (!_buckets[b].compare_exchange_strong(expected, bucket)) {
+				delete[] bucket;
+				bucket = expected;
+			}
+		}
+
+		return bucket ? &bucket[offset] : NULL;
+	}
+
+	mutable std::atomic<std::atomic<const char*>*> _buckets[N_BUCKETS];
+	Shard                                          _shards[N_SHARDS];
+	std::atomic<LV2_URID>                          _next;
+};
+
+/** Return the URI table, which lives as long as the process. */
+URITable&
+uri_table()
+{
+	static URITable* const table = new URITable();
+	return *table;
+}
+
+} // namespace
+
 URIMap::URIMap(Log& log, LV2_URID_Map* map, LV2_URID_Unmap* unmap)
 	: _urid_map_feature(new URIDMapFeature(this, map, log))
 	, _urid_unmap_feature(new URIDUnmapFeature(this, unmap))
@@ -48,12 +239,20 @@ LV2_URID
 URIMap::URIDMapFeature::default_map(LV2_URID_Map_Handle handle,
                                     const char*         uri)
 {
-	return static_cast<LV2_URID>(g_quark_from_string(uri));
+	return uri_table().map(uri);
 }
 
 LV2_URID
 URIMap::URIDMapFeature::map(const char* uri)
 {
+	if (urid_map.map == default_map) {
+		// Only validate URIs the first time they are mapped
+		const LV2_URID urid = uri_table().find(uri);
+		if (urid) {
+			return urid;
+		}
+	}
+
 	if (!Raul::URI::is_valid(uri)) {
 		log.error(fmt("Attempt to map invalid URI <%1%>\n") % uri);
 		return 0;
@@ -77,7 +276,7 @@ const char*
 URIMap::URIDUnmapFeature::default_unmap(LV2_URID_Unmap_Handle handle,
                                         LV2_URID              urid)
 {
-	return g_quark_to_string(urid);
+	return uri_table().unmap(urid);
 }
 
 const char*
@@ -82,6 +82,8 @@ URIs::URIs(Forge& f, URIMap* map, LilvWorld* lworld)
 	, doap_name             (forge, map, lworld, "http://usefulinc.com/ns/doap#name")
 	, ingen_Arc             (forge, map, lworld, INGEN__Arc)
 	, ingen_Block           (forge, map, lworld, INGEN__Block)
+	, ingen_BundleEnd       (forge, map, lworld, INGEN__BundleEnd)
+	, ingen_BundleStart     (forge, map, lworld, INGEN__BundleStart)
 	, ingen_Graph           (forge, map, lworld, INGEN__Graph)
 	, ingen_GraphPrototype  (forge, map, lworld, INGEN__GraphPrototype)
 	, ingen_Internal        (forge, map, lworld, INGEN__Internal)
@@ -91,14 +93,19 @@ URIs::URIs(Forge& f, URIMap* map, LilvWorld* lworld)
 	, ingen_broadcast       (forge, map, lworld, INGEN__broadcast)
 	, ingen_canvasX         (forge, map, lworld, INGEN__canvasX)
 	, ingen_canvasY         (forge, map, lworld, INGEN__canvasY)
+	, ingen_cpuLoad         (forge, map, lworld, INGEN__cpuLoad)
+	, ingen_cycleStats      (forge, map, lworld, INGEN__cycleStats)
 	, ingen_enabled         (forge, map, lworld, INGEN__enabled)
+	, ingen_eventPoolSize   (forge, map, lworld, INGEN__eventPoolSize)
 	, ingen_file            (forge, map, lworld, INGEN__file)
 	, ingen_head            (forge, map, lworld, INGEN__head)
 	, ingen_incidentTo      (forge, map, lworld, INGEN__incidentTo)
 	, ingen_loadedBundle    (forge, map, lworld, INGEN__loadedBundle)
 	, ingen_polyphonic      (forge, map, lworld, INGEN__polyphonic)
 	, ingen_polyphony       (forge, map, lworld, INGEN__polyphony)
+	, ingen_profile         (forge, map, lworld, INGEN__profile)
 	, ingen_prototype       (forge, map, lworld, INGEN__prototype)
+	, ingen_sampleAccurate  (forge, map, lworld, INGEN__sampleAccurate)
 	, ingen_sprungLayout    (forge, map, lworld, INGEN__sprungLayout)
 	, ingen_tail            (forge, map, lworld, INGEN__tail)
 	, ingen_uiEmbedded      (forge, map, lworld, INGEN__uiEmbedded)
@@ -61,9 +61,7 @@ ObjectModel::on_property_removed(const Raul::URI& uri, const Atom& value)
 const Atom&
 ObjectModel::get_property(const Raul::URI& key) const
 {
-	static const Atom null_atom;
-	Resource::Properties::const_iterator i = properties().find(key);
-	return (i != properties().end()) ? i->second : null_atom;
+	return Resource::get_property(key);
 }
 
 bool
@@ -691,6 +691,9 @@ GraphCanvas::paste()
 	const int paste_x = widget_point_x + scroll_x + (20.0f * _paste_count);
 	const int paste_y = widget_point_y + scroll_y + (20.0f * _paste_count);
 
+	// Paste everything in one bundle so the engine applies it atomically
+	_app.interface()->bundle_begin();
+
 	// Put each top level object in the clipboard store
 	ClashAvoider avoider(*_app.store().get());
 	for (const auto& c : clipboard) {
@@ -707,18 +710,19 @@ GraphCanvas::paste()
 		                        _app.forge().alloc_uri(old_uri)}};
 
 		// Set the same types
-		const auto t = node->properties().equal_range(uris.rdf_type);
+		const Node::Properties node_props = node->properties();
+		const auto t = node_props.equal_range(uris.rdf_type);
 		props.insert(t.first, t.second);
 
 		// Set coordinates so paste origin is at the mouse pointer
-		PropIter xi = node->properties().find(uris.ingen_canvasX);
-		PropIter yi = node->properties().find(uris.ingen_canvasY);
-		if (xi != node->properties().end()) {
+		PropIter xi = node_props.find(uris.ingen_canvasX);
+		PropIter yi = node_props.find(uris.ingen_canvasY);
+		if (xi != node_props.end()) {
 			const float x = xi->second.get<float>() - min_x + paste_x;
 			props.insert({xi->first, Resource::Property(_app.forge().make(x),
 			                                            xi->second.context())});
 		}
-		if (yi != node->properties().end()) {
+		if (yi != node_props.end()) {
 			const float y = yi->second.get<float>() - min_y + paste_y;
 			props.insert({yi->first, Resource::Property(_app.forge().make(y),
 			                                            yi->second.context())});
@@ -734,6 +738,8 @@ GraphCanvas::paste()
 			avoider.map_path(parent.child(a.second->tail_path())),
 			avoider.map_path(parent.child(a.second->head_path())));
 	}
+
+	_app.interface()->bundle_end();
 }
 
 void
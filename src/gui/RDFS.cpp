@@ -120,7 +120,8 @@ types(World* world, SPtr<const Client::ObjectModel> model)
 	// Start with every rdf:type
 	URISet types;
 	types.insert(Raul::URI(LILV_NS_RDFS "Resource"));
-	PropRange range = model->properties().equal_range(world->uris().rdf_type);
+	const Resource::Properties props = model->properties();
+	PropRange                  range = props.equal_range(world->uris().rdf_type);
 	for (PropIter t = range.first; t != range.second; ++t) {
 		if (t->second.type() == world->forge().URI ||
 		    t->second.type() == world->forge().URID) {
@@ -148,8 +148,13 @@ main(int argc, char** argv)
 	}
 
 	// Activate the engine, if we have one
+	const bool render = conf.option("render").is_valid();
 	if (world->engine()) {
-		ingen_try(world->load_module("jack"), "Failed to load jack module");
+		if (render) {
+			ingen_try(world->load_module("render"), "Failed to load render module");
+		} else {
+			ingen_try(world->load_module("jack"), "Failed to load jack module");
+		}
 		world->engine()->activate();
 	}
 
@@ -217,7 +222,10 @@ main(int argc, char** argv)
 	signal(SIGINT, ingen_interrupt);
 	signal(SIGTERM, ingen_interrupt);
 
-	if (conf.option("gui").get<int32_t>()) {
+	if (render && world->engine()) {
+		// Render to files as fast as possible, then exit
+		world->run_module("render");
+	} else if (conf.option("gui").get<int32_t>()) {
 		world->run_module("gui");
 	} else if (world->engine()) {
 		// Run engine main loop until interrupt
@@ -22,6 +22,7 @@
 #include "Buffer.hpp"
 #include "Engine.hpp"
 #include "BlockImpl.hpp"
+#include "CompiledGraph.hpp"
 #include "GraphImpl.hpp"
 #include "PluginImpl.hpp"
 #include "PortImpl.hpp"
@@ -33,6 +34,9 @@ using namespace std;
 namespace Ingen {
 namespace Server {
 
+/** Id of the next block to be created. */
+static std::atomic<uint64_t> next_block_id(1);
+
 BlockImpl::BlockImpl(PluginImpl*         plugin,
                      const Raul::Symbol& symbol,
                      bool                polyphonic,
@@ -44,8 +48,12 @@ BlockImpl::BlockImpl(PluginImpl*         plugin,
 	, _context(Context::ID::AUDIO)
 	, _polyphony((polyphonic && parent) ? parent->internal_poly() : 1)
 	, _polyphonic(polyphonic)
+	, _id(next_block_id++)
 	, _activated(false)
 	, _enabled(true)
+	, _order_index(0)
+	, _mark(0)
+	, _run_time(0)
 	, _traversed(false)
 {
 	assert(_plugin);
@@ -184,23 +192,25 @@ BlockImpl::pre_process(ProcessContext& context)
 	for (uint32_t i = 0; i < num_ports(); ++i) {
 		PortImpl* const port = _ports->at(i);
 		port->pre_process(context);
-		port->connect_buffers();
+		port->connect_buffers(context);
 	}
 }
 
 void
-BlockImpl::process(ProcessContext& context)
+BlockImpl::process(ProcessContext& context, const CompiledBlock& compiled)
 {
 	pre_process(context);
 
 	if (!_enabled) {
 		// Prepare port buffers for reading, converting/mixing if necessary
 		for (uint32_t i = 0; _ports && i < _ports->size(); ++i) {
-			_ports->at(i)->connect_buffers();
+			_ports->at(i)->connect_buffers(context);
 			_ports->at(i)->pre_run(context);
 		}
 
 		// Dumb bypass
+		const uint32_t first = context.first_voice();
+		const uint32_t end   = context.end_voice(_polyphony);
 		for (PortType t : { PortType::AUDIO, PortType::CV, PortType::ATOM }) {
 			for (uint32_t i = 0;; ++i) {
 				PortImpl* in  = nth_port_by_type(i, true, t);
@@ -209,12 +219,12 @@ BlockImpl::process(ProcessContext& context)
 					break;  // Finished writing all outputs
 				} else if (in) {
 					// Copy corresponding input to output
-					for (uint32_t v = 0; v < _polyphony; ++v) {
+					for (uint32_t v = first; v < end; ++v) {
 						out->buffer(v)->copy(context, in->buffer(v).get());
 					}
 				} else {
 					// Output but no corresponding input, clear
-					for (uint32_t v = 0; v < _polyphony; ++v) {
+					for (uint32_t v = first; v < end; ++v) {
 						out->buffer(v)->clear();
 					}
 				}
@@ -228,23 +238,24 @@ BlockImpl::process(ProcessContext& context)
 	for (SampleCount offset = 0; offset < context.nframes();) {
 		// Find earliest offset of a value change
 		SampleCount chunk_end = context.nframes();
-		for (uint32_t i = 0; _ports && i < _ports->size(); ++i) {
-			PortImpl* const port = _ports->at(i);
-			if (port->type() == PortType::CONTROL && port->is_input()) {
-				const SampleCount o = port->next_value_offset(
-					offset, context.nframes());
-				if (o < chunk_end) {
-					chunk_end = o;
-				}
+		for (PortImpl* const port : compiled.value_ports()) {
+			const SampleCount o = port->next_value_offset(
+				context, offset, context.nframes());
+			if (o < chunk_end) {
+				chunk_end = o;
 			}
 		}
 
 		// Slice context into a chunk from now until the next change
 		subcontext.slice(offset, chunk_end - offset);
 
-		// Prepare port buffers for reading, converting/mixing if necessary
+		/* Prepare port buffers for reading, converting/mixing if necessary.
+		   Buffers were connected at the start of the cycle in pre_process(),
+		   so only need to be reconnected for later chunks. */
 		for (uint32_t i = 0; _ports && i < _ports->size(); ++i) {
-			_ports->at(i)->connect_buffers(offset);
+			if (offset > 0) {
+				_ports->at(i)->connect_buffers(context, offset);
+			}
 			_ports->at(i)->pre_run(subcontext);
 		}
 
@@ -17,6 +17,7 @@
 #ifndef INGEN_ENGINE_BLOCKIMPL_HPP
 #define INGEN_ENGINE_BLOCKIMPL_HPP
 
+#include <atomic>
 #include <set>
 
 #include <boost/intrusive/slist.hpp>
@@ -42,6 +43,7 @@ namespace Server {
 
 class Buffer;
 class BufferFactory;
+class CompiledBlock;
 class Context;
 class Engine;
 class GraphImpl;
@@ -90,6 +92,13 @@ public:
 	                             const Raul::Symbol& symbol,
 	                             GraphImpl*          parent) { return NULL; }
 
+	/** Return a number which identifies this block.
+	 *
+	 * Unlike its address, this is never reused by another block, so it can be
+	 * used to check if a block recorded earlier still exists.
+	 */
+	uint64_t id() const { return _id; }
+
 	/** Return true iff this block is activated */
 	bool activated() const { return _activated; }
 
@@ -116,8 +125,11 @@ public:
 	/** Do whatever needs doing in the process thread before process() is called */
 	virtual void pre_process(ProcessContext& context);
 
-	/** Run block for an entire process cycle (calls run()). */
-	virtual void process(ProcessContext& context);
+	/** Run block for an entire process cycle (calls run()).
+	 *
+	 * @param compiled Information about this block from the compiled graph.
+	 */
+	virtual void process(ProcessContext& context, const CompiledBlock& compiled);
 
 	/** Run block for a portion of process cycle (called from process()). */
 	virtual void run(ProcessContext& context) = 0;
@@ -151,6 +163,13 @@ public:
 	 */
 	virtual void set_polyphonic(bool p) { _polyphonic = p; }
 
+	/** Return true iff each voice of this block can be run independently.
+	 *
+	 * The voices of such a block may be run in separate threads, one context
+	 * slice (see Context::slice_voices()) at a time.
+	 */
+	virtual bool voices_independent() const { return false; }
+
 	virtual bool prepare_poly(BufferFactory& bufs, uint32_t poly);
 	virtual bool apply_poly(
 		ProcessContext& context, Raul::Maid& maid, uint32_t poly);
@@ -183,6 +202,28 @@ public:
 	bool traversed() const { return _traversed; }
 	void traversed(bool b) { _traversed = b; }
 
+	/** Position of this block in its parent graph's execution order. */
+	uint32_t order_index() const { return _order_index; }
+	void     order_index(uint32_t i) { _order_index = i; }
+
+	/** Scratch value for compiling the parent graph (pre-processor only). */
+	uint32_t mark() const { return _mark; }
+	void     mark(uint32_t m) { _mark = m; }
+
+	/** Add to the time spent processing this block (profiling only).
+	 *
+	 * This may be called by several threads at once if voices are run in
+	 * parallel, in which case the time of every voice is counted.
+	 */
+	void add_run_time(uint64_t ns) {
+		_run_time.fetch_add(ns, std::memory_order_relaxed);
+	}
+
+	/** Return and reset the time spent processing this block in ns. */
+	uint64_t take_run_time() {
+		return _run_time.exchange(0, std::memory_order_relaxed);
+	}
+
 protected:
 	PortImpl* nth_port_by_type(uint32_t n, bool input, PortType type);
 
@@ -193,8 +234,12 @@ protected:
 	std::set<BlockImpl*>    _providers; ///< Blocks connected to this one's input ports
 	std::set<BlockImpl*>    _dependants; ///< Blocks this one's output ports are connected to
 	bool                    _polyphonic;
+	const uint64_t          _id; ///< Unique number, see id()
 	bool                    _activated;
 	bool                    _enabled;
+	uint32_t                _order_index; ///< Position in parent's execution order
+	uint32_t                _mark; ///< Scratch value for compiling parent
+	std::atomic<uint64_t>   _run_time; ///< Processing time in ns, when profiling
 	bool                    _traversed; ///< Flag for process order algorithm
 };
 
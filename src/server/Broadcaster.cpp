@@ -17,6 +17,7 @@
 #include <utility>
 
 #include "ingen/Interface.hpp"
+#include "ingen/URIMap.hpp"
 
 #include "Broadcaster.hpp"
 #include "PluginImpl.hpp"
@@ -25,9 +26,13 @@
 namespace Ingen {
 namespace Server {
 
-Broadcaster::Broadcaster()
-	: _must_broadcast(false)
+Broadcaster::Broadcaster(URIMap& map, URIs& uris)
+	: _map(map)
+	, _uris(uris)
+	, _must_broadcast(false)
 	, _bundle_depth(0)
+	, _writer(map, uris, _forged)
+	, _n_sinks(0)
 {}
 
 Broadcaster::~Broadcaster()
@@ -43,7 +48,10 @@ void
 Broadcaster::register_client(SPtr<Interface> client)
 {
 	std::lock_guard<std::mutex> lock(_clients_mutex);
-	_clients.insert(client);
+	BroadcastSink* const sink = dynamic_cast<BroadcastSink*>(client.get());
+	if (_clients.insert(std::make_pair(client, sink)).second && sink) {
+		++_n_sinks;
+	}
 }
 
 /** Remove a client from the list of registered clients.
@@ -54,9 +62,18 @@ bool
 Broadcaster::unregister_client(SPtr<Interface> client)
 {
 	std::lock_guard<std::mutex> lock(_clients_mutex);
-	const size_t erased = _clients.erase(client);
+	Clients::iterator c = _clients.find(client);
+	if (c == _clients.end()) {
+		_broadcastees.erase(client);
+		return false;
+	}
+
+	if (c->second) {
+		--_n_sinks;
+	}
+	_clients.erase(c);
 	_broadcastees.erase(client);
-	return (erased > 0);
+	return true;
 }
 
 void
@@ -75,7 +92,7 @@ Broadcaster::send_plugins(const BlockFactory::Plugins& plugins)
 {
 	std::lock_guard<std::mutex> lock(_clients_mutex);
 	for (const auto& c : _clients) {
-		send_plugins_to(c.get(), plugins);
+		send_plugins_to(c.first.get(), plugins);
 	}
 }
 
@@ -93,5 +110,91 @@ Broadcaster::send_plugins_to(Interface*                   client,
 	client->bundle_end();
 }
 
+MonitorUpdates::MonitorUpdates(Broadcaster& broadcaster)
+	: _broadcaster(broadcaster)
+	, _lock(broadcaster._clients_mutex)
+	, _n_updates(0)
+	, _n_batched(0)
+{}
+
+MonitorUpdates::~MonitorUpdates()
+{
+	if (!_n_updates) {
+		return;
+	}
+
+	send_batch(true);
+
+	Broadcaster&           b    = _broadcaster;
+	const SPtr<Interface>& skip = b._ignore_client;
+	for (const auto& c : b._clients) {
+		if (!c.second && c.first != skip) {
+			c.first->bundle_end();
+		}
+	}
+}
+
+void
+MonitorUpdates::send_batch(bool monitor)
+{
+	if (!_n_batched) {
+		return;
+	}
+
+	Broadcaster& b = _broadcaster;
+	b._writer.bundle_end();
+	b._forged.batching = false;
+	_n_batched         = 0;
+
+	const SPtr<Interface>&     skip = b._ignore_client;
+	const SPtr<const LV2_Atom> msg  = b._forged.take_batch(b._uris.forge.Tuple);
+	for (const auto& c : b._clients) {
+		if (c.second && c.first != skip) {
+			c.second->broadcast(msg, monitor);
+		}
+	}
+}
+
+void
+MonitorUpdates::set_property(const Raul::URI& subject,
+                             LV2_URID         key,
+                             const LV2_Atom*  value)
+{
+	Broadcaster&           b    = _broadcaster;
+	const SPtr<Interface>& skip = b._ignore_client;
+	if (_n_updates++ == 0) {
+		for (const auto& c : b._clients) {
+			if (!c.second && c.first != skip) {
+				c.first->bundle_begin();
+			}
+		}
+	}
+
+	if (b._n_sinks) {
+		if (_n_batched++ == 0) {
+			b._forged.batching = true;
+			b._writer.bundle_begin();
+		}
+		b._writer.set_property(subject, key, value);
+		if (key != b._uris.ingen_value.urid &&
+		    key != b._uris.ingen_activity.urid) {
+			send_batch(false);  // Never drop this, or what came before it
+		}
+	}
+
+	const char* key_uri = NULL;
+	for (const auto& c : b._clients) {
+		if (!c.second && c.first != skip) {
+			if (!key_uri && !(key_uri = b._map.unmap_uri(key))) {
+				return;  // Unknown key, which sinks are sent as a URID anyway
+			}
+			c.first->set_property(
+				subject,
+				Raul::URI(key_uri),
+				Atom(value->size, value->type, LV2_ATOM_BODY_CONST(value)));
+		}
+	}
+}
+
 } // namespace Server
 } // namespace Ingen
@@ -17,31 +17,79 @@
 #ifndef INGEN_ENGINE_BROADCASTER_HPP
 #define INGEN_ENGINE_BROADCASTER_HPP
 
+#include <stdlib.h>
+#include <string.h>
+
 #include <atomic>
 #include <list>
+#include <map>
 #include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 
+#include "ingen/AtomSink.hpp"
+#include "ingen/AtomWriter.hpp"
 #include "ingen/Interface.hpp"
+#include "ingen/URIs.hpp"
 #include "ingen/types.hpp"
+#include "lv2/lv2plug.in/ns/ext/atom/util.h"
 
 #include "BlockFactory.hpp"
 
 namespace Ingen {
+
+class URIMap;
+
 namespace Server {
 
+/** Return a new shared copy of `atom`. */
+inline SPtr<const LV2_Atom>
+share_atom(const LV2_Atom* atom)
+{
+	const uint32_t size = lv2_atom_total_size(atom);
+	LV2_Atom*      copy = (LV2_Atom*)malloc(size);
+	memcpy(copy, atom, size);
+	return SPtr<const LV2_Atom>(copy, free);
+}
+
+/** A client that can be sent broadcasts as shared atoms.
+ *
+ * The broadcaster forges each message once and passes the same immutable atom
+ * to every such client, which may queue it to be sent by another thread.
+ *
+ * \ingroup engine
+ */
+class BroadcastSink
+{
+public:
+	virtual ~BroadcastSink() {}
+
+	/** Send a broadcast message.
+	 *
+	 * @param msg The message, or an atom:Tuple of messages to send in order.
+	 *
+	 * @param monitor True iff this is a port value or activity update, which
+	 * may be dropped if the client is too far behind.
+	 */
+	virtual void broadcast(SPtr<const LV2_Atom> msg, bool monitor) = 0;
+};
+
 /** Broadcaster for all clients.
  *
  * This is an Interface that forwards all messages to all registered
  * clients (for updating all clients on state changes in the engine).
  *
+ * Clients that are a BroadcastSink share a single forged copy of each
+ * message, so the cost of broadcasting to them is independent of their
+ * number and speed.  Other clients are called directly.
+ *
  * \ingroup engine
  */
 class Broadcaster : public Interface
 {
 public:
-	Broadcaster();
+	Broadcaster(URIMap& map, URIs& uris);
 	~Broadcaster();
 
 	void register_client(SPtr<Interface> client);
@@ -88,13 +136,23 @@ public:
 	void send_plugins(const BlockFactory::Plugins& plugin_list);
 	void send_plugins_to(Interface*, const BlockFactory::Plugins& plugin_list);
 
-#define BROADCAST(msg, ...) \
+#define BROADCAST_AS(monitor, method, ...) \
 	std::lock_guard<std::mutex> lock(_clients_mutex); \
+	if (_n_sinks) { \
+		_writer.method(__VA_ARGS__); \
+	} \
 	for (const auto& c : _clients) { \
-		if (c != _ignore_client) { \
-			c->msg(__VA_ARGS__); \
+		if (c.first != _ignore_client) { \
+			if (c.second) { \
+				c.second->broadcast(_forged.msg, monitor); \
+			} else { \
+				c.first->method(__VA_ARGS__); \
+			} \
 		} \
 	} \
+	_forged.msg.reset();
+
+#define BROADCAST(method, ...) BROADCAST_AS(false, method, __VA_ARGS__)
 
 	void bundle_begin() { BROADCAST(bundle_begin); }
 	void bundle_end()   { BROADCAST(bundle_end); }
@@ -143,7 +201,9 @@ public:
 	void set_property(const Raul::URI& subject,
 	                  const Raul::URI& predicate,
 	                  const Atom&      value) {
-		BROADCAST(set_property, subject, predicate, value);
+		const bool monitor = (predicate == _uris.ingen_value ||
+		                      predicate == _uris.ingen_activity);
+		BROADCAST_AS(monitor, set_property, subject, predicate, value);
 	}
 
 	Raul::URI uri() const { return Raul::URI("ingen:/broadcaster"); }
@@ -156,15 +216,93 @@ public:
 
 private:
 	friend class Transfer;
+	friend class MonitorUpdates;
+
+	/** Sink that keeps a shared copy of the last forged message.
+	 *
+	 * While batching, messages are instead appended to the body of a tuple.
+	 */
+	struct Forged : public AtomSink {
+		Forged() : batching(false) {}
+
+		bool write(const LV2_Atom* atom) {
+			if (batching) {
+				const uint8_t* const bytes = (const uint8_t*)atom;
+				batch.insert(batch.end(),
+				             bytes, bytes + lv2_atom_total_size(atom));
+				batch.resize(lv2_atom_pad_size(batch.size()));
+			} else {
+				msg = share_atom(atom);
+			}
+			return true;
+		}
 
-	typedef std::set<SPtr<Interface>> Clients;
+		/** Return the batch as a new shared tuple, and clear it. */
+		SPtr<const LV2_Atom> take_batch(LV2_URID tuple_type) {
+			LV2_Atom* const tuple = (LV2_Atom*)malloc(
+				sizeof(LV2_Atom) + batch.size());
+			tuple->size = batch.size();
+			tuple->type = tuple_type;
+			memcpy(tuple + 1, batch.data(), batch.size());
+			batch.clear();
+			return SPtr<const LV2_Atom>(tuple, free);
+		}
+
+		SPtr<const LV2_Atom> msg;
+		std::vector<uint8_t> batch;     ///< Body of tuple being built
+		bool                 batching;  ///< True iff appending to batch
+	};
 
+	/** Clients, and the same client as a BroadcastSink if it is one. */
+	typedef std::map<SPtr<Interface>, BroadcastSink*> Clients;
+
+	URIMap&                     _map;
+	URIs&                       _uris;
 	std::mutex                  _clients_mutex;
 	Clients                     _clients;
 	std::set< SPtr<Interface> > _broadcastees;
 	std::atomic<bool>           _must_broadcast;
 	unsigned                    _bundle_depth;
 	SPtr<Interface>             _ignore_client;
+	Forged                      _forged;   ///< Last forged message
+	AtomWriter                  _writer;   ///< Forges messages for sinks
+	unsigned                    _n_sinks;  ///< Number of BroadcastSinks
+};
+
+/** A bundle of port value and activity updates for all clients.
+ *
+ * Updates are forged from mapped keys into a single atom:Tuple, which is
+ * passed to every BroadcastSink as one message when this goes out of scope.
+ * Keys are only converted to URIs for clients that are not sinks, which are
+ * sent the updates as a bundle.  Nothing is sent if there are no updates.
+ *
+ * Sinks may drop the tuple if it only contains monitor updates (ingen:value
+ * and ingen:activity).  Any other update, like a learned MIDI binding, ends
+ * the tuple so far, which is then sent as one that must not be dropped.
+ *
+ * The broadcaster's clients are locked for the lifetime of this object.
+ *
+ * \ingroup engine
+ */
+class MonitorUpdates : public Raul::Noncopyable
+{
+public:
+	explicit MonitorUpdates(Broadcaster& broadcaster);
+	~MonitorUpdates();
+
+	/** Add an update which sets `key` on `subject` to `value`. */
+	void set_property(const Raul::URI& subject,
+	                  LV2_URID         key,
+	                  const LV2_Atom*  value);
+
+private:
+	/** Send the updates batched so far to every sink. */
+	void send_batch(bool monitor);
+
+	Broadcaster&                _broadcaster;
+	std::lock_guard<std::mutex> _lock;
+	unsigned                    _n_updates;  ///< Updates in total
+	unsigned                    _n_batched;  ///< Updates in tuple for sinks
 };
 
 } // namespace Server
@@ -31,8 +31,15 @@ ClientUpdate::put(const Raul::URI&            uri,
                   const Resource::Properties& props,
                   Resource::Graph             ctx)
 {
-	const ClientUpdate::Put put = { uri, props, ctx };
-	puts.push_back(put);
+	puts.push_back(Put{ uri, props, ctx });
+}
+
+void
+ClientUpdate::put(const Raul::URI&       uri,
+                  Resource::Properties&& props,
+                  Resource::Graph        ctx)
+{
+	puts.push_back(Put{ uri, std::move(props), ctx });
 }
 
 void
@@ -40,10 +47,16 @@ ClientUpdate::put_port(const PortImpl* port)
 {
 	const URIs& uris = port->bufs().uris();
 	if (port->is_a(PortType::CONTROL) || port->is_a(PortType::CV)) {
-		Resource::Properties props = port->properties();
-		props.erase(uris.ingen_value);
-		props.insert(std::make_pair(uris.ingen_value, port->value()));
-		put(port->uri(), props);
+		// Copy properties once and replace the value in place
+		Resource::Properties           props = port->properties();
+		Resource::Properties::iterator v     = props.find(uris.ingen_value);
+		if (v != props.end()) {
+			v->second = Resource::Property(port->value());
+			props.erase(++v, props.upper_bound(uris.ingen_value));
+		} else {
+			props.emplace(uris.ingen_value, port->value());
+		}
+		put(port->uri(), std::move(props));
 	} else {
 		put(port->uri(), port->properties());
 	}
@@ -46,6 +46,10 @@ struct ClientUpdate {
 	         const Resource::Properties& props,
 	         Resource::Graph             ctx=Resource::Graph::DEFAULT);
 
+	void put(const Raul::URI&       uri,
+	         Resource::Properties&& props,
+	         Resource::Graph        ctx=Resource::Graph::DEFAULT);
+
 	void put_port(const PortImpl* port);
 	void put_block(const BlockImpl* block);
 	void put_graph(const GraphImpl* graph);
@@ -0,0 +1,225 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+
+#include "BlockImpl.hpp"
+#include "CompiledGraph.hpp"
+#include "Engine.hpp"
+#include "ProcessContext.hpp"
+
+namespace Ingen {
+namespace Server {
+
+void
+CompiledBlock::process(ProcessContext& context) const
+{
+	if (!context.engine().profiling()) {
+		_block->process(context, *this);
+		return;
+	}
+
+	typedef std::chrono::steady_clock Clock;
+
+	const Clock::time_point start = Clock::now();
+	_block->process(context, *this);
+	const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		Clock::now() - start).count();
+
+	_block->add_run_time(ns);
+	if (_block->graph_type() == Node::GraphType::BLOCK) {
+		// Only leaf blocks, since graphs are always slower than their blocks
+		context.block_time(_block, ns);
+	}
+}
+
+void
+CompiledGraph::prepare()
+{
+	if (levelled()) {
+		_level_next  = Counts(_level_ends.size());
+		_parallelism = 0;
+		uint32_t begin = 0;
+		for (uint32_t end : _level_ends) {
+			_parallelism = std::max(_parallelism, end - begin);
+			begin        = end;
+		}
+	} else {
+		_n_waiting   = Counts(size());
+		_ready       = Queue(size());
+		_parallelism = size();
+	}
+}
+
+void
+CompiledGraph::reset()
+{
+	_n_finished = 0;
+	_n_voices   = 0;
+
+	if (levelled()) {
+		for (size_t l = 0; l < _level_ends.size(); ++l) {
+			_level_next[l] = (l == 0) ? 0 : _level_ends[l - 1];
+		}
+		return;
+	}
+
+	assert(_n_waiting.size() == size());
+
+	_ready_head = 0;
+	_ready_tail = 0;
+	for (size_t i = 0; i < size(); ++i) {
+		_ready[i] = NULL;
+		_n_waiting[i] = (*this)[i].n_providers();
+	}
+
+	// Blocks with no providers are ready to go immediately
+	for (size_t i = 0; i < size(); ++i) {
+		if ((*this)[i].n_providers() == 0) {
+			push(&(*this)[i]);
+		}
+	}
+}
+
+void
+CompiledGraph::run_before_voices(ProcessContext& context)
+{
+	for (uint32_t i : _before_voices) {
+		(*this)[i].process(context);
+	}
+}
+
+void
+CompiledGraph::reset_voices(uint32_t n_voices)
+{
+	_n_voices   = n_voices;
+	_next_voice = 0;
+}
+
+void
+CompiledGraph::run_after_voices(ProcessContext& context)
+{
+	/* Voices were run without doing any shared work like monitoring, so do it
+	   now that every voice is finished. */
+	context.slice_voices(0, 0, true);
+	for (uint32_t i : _voice_blocks) {
+		(*this)[i].block()->post_process(context);
+	}
+	context.unslice_voices();
+
+	for (uint32_t i : _after_voices) {
+		(*this)[i].process(context);
+	}
+
+	_n_voices = 0;
+}
+
+void
+CompiledGraph::work(ProcessContext& context)
+{
+	if (_n_voices) {
+		work_voices(context);
+	} else if (levelled()) {
+		work_levels(context);
+	} else {
+		work_dynamic(context);
+	}
+}
+
+void
+CompiledGraph::work_levels(ProcessContext& context)
+{
+	for (size_t l = 0; l < _level_ends.size(); ++l) {
+		// Claim and execute blocks in this level until there are none left
+		const uint32_t end = _level_ends[l];
+		for (uint32_t i; (i = _level_next[l]++) < end;) {
+			(*this)[i].process(context);
+			++_n_finished;
+		}
+
+		/* Wait for other threads to finish this level.  Blocks are sorted by
+		   level, so the level is complete when this many blocks are done. */
+		while (_n_finished.load() < end) {}
+	}
+}
+
+void
+CompiledGraph::work_voices(ProcessContext& context)
+{
+	// Claim voices and run every per-voice block for them until none are left
+	for (uint32_t v; (v = _next_voice++) < _n_voices;) {
+		context.slice_voices(v, v + 1, false);
+		for (uint32_t i : _voice_blocks) {
+			(*this)[i].process(context);
+		}
+	}
+	context.unslice_voices();
+}
+
+void
+CompiledGraph::work_dynamic(ProcessContext& context)
+{
+	while (!done()) {
+		CompiledBlock* const block = steal();
+		if (block) {
+			block->process(context);
+			finish(*block);
+		}
+	}
+}
+
+CompiledBlock*
+CompiledGraph::steal()
+{
+	uint32_t head = _ready_head.load();
+	while (head < _ready_tail.load()) {
+		if (_ready_head.compare_exchange_weak(head, head + 1)) {
+			/* We own this slot now, but the pushing thread may not have
+			   written it yet, so wait for it to appear. */
+			CompiledBlock* block = NULL;
+			while (!(block = _ready[head].load())) {}
+			return block;
+		}
+	}
+	return NULL;
+}
+
+void
+CompiledGraph::push(CompiledBlock* block)
+{
+	/* Every block is pushed exactly once per run, so there is always room and
+	   the queue never needs to wrap around. */
+	const uint32_t slot = _ready_tail.fetch_add(1);
+	assert(slot < _ready.size());
+	_ready[slot] = block;
+}
+
+void
+CompiledGraph::finish(const CompiledBlock& block)
+{
+	for (uint32_t d : block.dependants()) {
+		if (_n_waiting[d].fetch_sub(1) == 1) {
+			// That was the last provider, dependant is now ready
+			push(&(*this)[d]);
+		}
+	}
+	++_n_finished;
+}
+
+} // namespace Server
+} // namespace Ingen
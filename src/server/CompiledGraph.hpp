@@ -17,6 +17,7 @@
 #ifndef INGEN_ENGINE_COMPILEDGRAPH_HPP
 #define INGEN_ENGINE_COMPILEDGRAPH_HPP
 
+#include <atomic>
 #include <vector>
 #include <list>
 
@@ -27,17 +28,47 @@ namespace Ingen {
 namespace Server {
 
 class BlockImpl;
+class PortImpl;
+class ProcessContext;
 
 /** All information required about a block to execute it in an audio thread.
+ *
+ * Anything about a block's connections that the audio thread would otherwise
+ * have to work out every cycle is found here in advance when compiling.
  */
 class CompiledBlock {
 public:
-	CompiledBlock(BlockImpl* b) : _block(b) {}
+	typedef std::vector<uint32_t>  Dependants;
+	typedef std::vector<PortImpl*> Ports;
+
+	CompiledBlock(BlockImpl* b) : _block(b), _n_providers(0) {}
 
 	BlockImpl* block() const { return _block; }
 
+	/** Process the block, measuring how long it takes if profiling. */
+	void process(ProcessContext& context) const;
+
+	/** Number of blocks that must be executed before this one. */
+	uint32_t n_providers() const { return _n_providers; }
+
+	/** Indices (in the CompiledGraph) of blocks that depend on this one. */
+	const Dependants& dependants() const { return _dependants; }
+
+	/** Control inputs that may change value part way through a cycle.
+	 *
+	 * These are connected to a sequence or CV output, so the block must be
+	 * run in chunks between value changes.  Typically there are none, and the
+	 * block is run for the whole cycle at once.
+	 */
+	const Ports& value_ports() const { return _value_ports; }
+
 private:
+	friend class GraphImpl;
+
 	BlockImpl* _block;
+	uint32_t   _n_providers;
+	Dependants _dependants;
+	Ports      _value_ports;
 };
 
 /** A graph ``compiled'' into a flat structure with the correct order so
@@ -47,11 +78,117 @@ private:
  * The blocks contained here are sorted in the order they must be executed.
  * The parallel processing algorithm guarantees no block will be executed
  * before its providers, using this order as well as semaphores.
+ *
+ * A graph may also be compiled into levels, where every block in a level
+ * depends only on blocks in previous levels.  In this case, threads execute
+ * all the blocks of a level in parallel and wait for the level to complete
+ * before moving on to the next, which has less overhead than tracking each
+ * block's providers individually.
+ *
+ * In a polyphonic graph, blocks whose voices are independent may instead be
+ * run one voice at a time: each thread claims a voice and runs every such
+ * block for it, which keeps a voice's buffers in one core's cache.  Blocks
+ * those depend on are run first, and blocks that depend on them last.
  */
 class CompiledGraph : public std::vector<CompiledBlock>
                     , public Raul::Maid::Disposable
                     , public Raul::Noncopyable
 {
+public:
+	CompiledGraph()
+		: _parallelism(0)
+		, _ready_head(0)
+		, _ready_tail(0)
+		, _n_finished(0)
+		, _n_voices(0)
+		, _next_voice(0)
+	{}
+
+	/** Allocate scheduling state (pre-process thread, after filling). */
+	void prepare();
+
+	/** Reset scheduling state for a new parallel run.
+	 *
+	 * Process thread only, this must be called before any threads start
+	 * working on the graph.
+	 */
+	void reset();
+
+	/** Execute ready blocks until every block in the graph has been run.
+	 *
+	 * This may be called from several threads at once, each block will be
+	 * executed exactly once, and never before all of its providers.  After
+	 * reset_voices(), this instead runs per-voice blocks until every voice
+	 * has been claimed.
+	 */
+	void work(ProcessContext& context);
+
+	/** Return true iff some blocks can be run one voice at a time. */
+	bool has_voice_blocks() const { return !_voice_blocks.empty(); }
+
+	/** Execute blocks that per-voice blocks depend on (all voices). */
+	void run_before_voices(ProcessContext& context);
+
+	/** Reset scheduling state for a parallel run of `n_voices` voices.
+	 *
+	 * Process thread only, this must be called after run_before_voices() and
+	 * before any threads start working on the graph.
+	 */
+	void reset_voices(uint32_t n_voices);
+
+	/** Execute blocks that depend on per-voice blocks (all voices).
+	 *
+	 * This must be called once every thread has finished working on voices.
+	 */
+	void run_after_voices(ProcessContext& context);
+
+	/** Return true iff every block has been executed this run. */
+	bool done() const { return _n_finished.load() == size(); }
+
+	/** Return true iff this graph is executed level by level. */
+	bool levelled() const { return !_level_ends.empty(); }
+
+	/** Return the maximum number of blocks that can be executed at once. */
+	uint32_t parallelism() const { return _parallelism; }
+
+private:
+	friend class GraphImpl;
+
+	typedef std::vector< std::atomic<uint32_t> >       Counts;
+	typedef std::vector< std::atomic<CompiledBlock*> > Queue;
+	typedef std::vector<uint32_t>                      Indices;
+
+	/** Execute blocks as soon as all their providers have finished. */
+	void work_dynamic(ProcessContext& context);
+
+	/** Execute blocks level by level, waiting for each level to finish. */
+	void work_levels(ProcessContext& context);
+
+	/** Execute per-voice blocks for one voice at a time. */
+	void work_voices(ProcessContext& context);
+
+	/** Pop a block that is ready to run, or return NULL. */
+	CompiledBlock* steal();
+
+	/** Push a block that is ready to run. */
+	void push(CompiledBlock* block);
+
+	/** Mark a block as finished, and push any dependants that become ready. */
+	void finish(const CompiledBlock& block);
+
+	Indices               _level_ends;    ///< Index one past the end of each level
+	uint32_t              _parallelism;   ///< Maximum concurrent blocks
+	Counts                _level_next;    ///< Next block to claim per level
+	Counts                _n_waiting;     ///< Unfinished providers per block
+	Queue                 _ready;         ///< Blocks ready to execute
+	std::atomic<uint32_t> _ready_head;    ///< Next ready block to execute
+	std::atomic<uint32_t> _ready_tail;    ///< Next free slot in _ready
+	std::atomic<uint32_t> _n_finished;    ///< Number of blocks executed
+	Indices               _before_voices; ///< Blocks run before voices
+	Indices               _voice_blocks;  ///< Blocks run one voice at a time
+	Indices               _after_voices;  ///< Blocks run after voices
+	uint32_t              _n_voices;      ///< Voices to run, or zero
+	std::atomic<uint32_t> _next_voice;    ///< Next voice to claim
 };
 
 } // namespace Server
@@ -14,6 +14,8 @@
   along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <string.h>
+
 #include "ingen/Forge.hpp"
 #include "ingen/Log.hpp"
 #include "ingen/URIMap.hpp"
@@ -27,21 +29,27 @@
 namespace Ingen {
 namespace Server {
 
+/** A fixed-size notification record in the ring.
+ *
+ * Values that fit in 64 bits, like port values and activity, are stored
+ * inline, so most notifications are a single record.  The body of a larger
+ * value follows the record in the ring.
+ */
 struct Notification
 {
-	inline Notification(PortImpl* p = 0,
-	                    FrameTime f = 0,
-	                    LV2_URID  k = 0,
-	                    uint32_t  s = 0,
-	                    LV2_URID  t = 0)
-		: port(p), time(f), key(k), size(s), type(t)
-	{}
+	/** Value, laid out like an LV2_Atom followed by its body. */
+	struct Value {
+		LV2_Atom atom;
+		uint64_t body;
+	};
+
+	/** Return true iff a value of `size` bytes is stored inline. */
+	static bool is_inline(uint32_t size) { return size <= sizeof(Value::body); }
 
 	PortImpl* port;
 	FrameTime time;
 	LV2_URID  key;
-	uint32_t  size;
-	LV2_URID  type;
+	Value     value;
 };
 
 Context::Context(Engine& engine, ID id)
@@ -53,6 +61,11 @@ Context::Context(Engine& engine, ID id)
 	, _end(0)
 	, _offset(0)
 	, _nframes(0)
+	, _first_voice(0)
+	, _end_voice(UINT32_MAX)
+	, _shared(true)
+	, _slowest(NULL)
+	, _slowest_time(0)
 	, _realtime(true)
 	, _copy(false)
 {}
@@ -65,6 +78,11 @@ Context::Context(const Context& copy)
 	, _end(copy._end)
 	, _offset(copy._offset)
 	, _nframes(copy._nframes)
+	, _first_voice(copy._first_voice)
+	, _end_voice(copy._end_voice)
+	, _shared(copy._shared)
+	, _slowest(NULL)
+	, _slowest_time(0)
 	, _realtime(copy._realtime)
 	, _copy(true)
 {}
@@ -90,13 +108,26 @@ Context::notify(LV2_URID    key,
                 LV2_URID    type,
                 const void* body)
 {
-	const Notification n(port, time, key, size, type);
-	if (_event_sink->write_space() < sizeof(n) + size) {
+	const bool     is_inline = Notification::is_inline(size);
+	const uint32_t body_size = is_inline ? 0 : size;
+	if (_event_sink->write_space() < sizeof(Notification) + body_size) {
 		return false;
 	}
+
+	Notification n;
+	n.port            = port;
+	n.time            = time;
+	n.key             = key;
+	n.value.atom.size = size;
+	n.value.atom.type = type;
+	n.value.body      = 0;
+	if (is_inline && size) {
+		memcpy(&n.value.body, body, size);
+	}
+
 	if (_event_sink->write(sizeof(n), &n) != sizeof(n)) {
 		_engine.log().error("Error writing header to notification ring\n");
-	} else if (_event_sink->write(size, body) != size) {
+	} else if (_event_sink->write(body_size, body) != body_size) {
 		_engine.log().error("Error writing body to notification ring\n");
 	} else {
 		return true;
@@ -104,40 +135,55 @@ Context::notify(LV2_URID    key,
 	return false;
 }
 
-void
-Context::emit_notifications(FrameTime end)
+bool
+Context::emit_notifications(FrameTime end, MonitorUpdates& updates)
 {
 	const URIs&    uris       = _engine.buffer_factory()->uris();
 	const uint32_t read_space = _event_sink->read_space();
 	Notification   note;
+	Atom           large;  // Storage for values that are not inline
 	for (uint32_t i = 0; i < read_space; i += sizeof(note)) {
 		if (_event_sink->peek(sizeof(note), &note) != sizeof(note) ||
 		    note.time >= end) {
-			return;
+			return true;
+		}
+		if (_event_sink->read(sizeof(note), &note) != sizeof(note)) {
+			_engine.log().error("Error reading header from notification ring\n");
+			return false;
 		}
-		if (_event_sink->read(sizeof(note), &note) == sizeof(note)) {
-			Atom value = _engine.world()->forge().alloc(
-				note.size, note.type, NULL);
-			if (_event_sink->read(note.size, value.get_body()) == note.size) {
-				i += note.size;
-				const char* key = _engine.world()->uri_map().unmap_uri(note.key);
-				if (key) {
-					_engine.broadcaster()->set_property(
-						note.port->uri(), Raul::URI(key), value);
-					if (note.port->is_input() && note.key == uris.ingen_value) {
-						// FIXME: not thread safe
-						note.port->set_property(uris.ingen_value, value);
-					}
-				} else {
-					_engine.log().error("Error unmapping notification key URI\n");
-				}
-			} else {
+
+		const LV2_Atom* value = &note.value.atom;
+		if (!Notification::is_inline(value->size)) {
+			large = Atom(value->size, value->type, NULL);
+			if (_event_sink->read(value->size, large.get_body()) != value->size) {
 				_engine.log().error("Error reading body from notification ring\n");
+				return false;
 			}
-		} else {
-			_engine.log().error("Error reading header from notification ring\n");
+			i    += value->size;
+			value = large.atom();
+		}
+
+		updates.set_property(note.port->uri(), note.key, value);
+		if (note.port->is_input() && note.key == uris.ingen_value) {
+			// FIXME: not thread safe
+			note.port->set_property(
+				uris.ingen_value,
+				Atom(value->size, value->type, LV2_ATOM_BODY_CONST(value)));
 		}
 	}
+	return true;
+}
+
+bool
+Context::next_notification_time(FrameTime& time)
+{
+	Notification note;
+	if (_event_sink->peek(sizeof(note), &note) != sizeof(note)) {
+		return false;
+	}
+
+	time = note.time;
+	return true;
 }
 
 } // namespace Server
@@ -17,6 +17,9 @@
 #ifndef INGEN_ENGINE_CONTEXT_HPP
 #define INGEN_ENGINE_CONTEXT_HPP
 
+#include <algorithm>
+#include <cstdint>
+
 #include "ingen/Atom.hpp"
 #include "ingen/World.hpp"
 #include "raul/RingBuffer.hpp"
@@ -26,7 +29,9 @@
 namespace Ingen {
 namespace Server {
 
+class BlockImpl;
 class Engine;
+class MonitorUpdates;
 class PortImpl;
 
 /** Graph execution context.
@@ -72,8 +77,17 @@ public:
 	            LV2_URID    type = 0,
 	            const void* body = NULL);
 
-	/** Emit pending notifications in some other non-realtime thread. */
-	void emit_notifications(FrameTime end);
+	/** Emit pending notifications in some other non-realtime thread.
+	 * @param end Emit only notifications before this time.
+	 * @param updates Bundle to add port updates to.
+	 * @return false on failure (ring is corrupt)
+	 */
+	bool emit_notifications(FrameTime end, MonitorUpdates& updates);
+
+	/** Get the time of the next pending notification.
+	 * @return false if no notifications are pending.
+	 */
+	bool next_notification_time(FrameTime& time);
 
 	/** Return true iff any notifications are pending. */
 	bool pending_notifications() const { return _event_sink->read_space(); }
@@ -97,6 +111,55 @@ public:
 		_nframes = nframes;
 	}
 
+	/** Restrict processing to voices in the range [begin, end).
+	 *
+	 * This is used to run several voices of a graph in parallel.  Work that
+	 * is not specific to any voice, like monitoring port values, is only done
+	 * if `shared` is true.
+	 */
+	inline void slice_voices(uint32_t begin, uint32_t end, bool shared) {
+		_first_voice = begin;
+		_end_voice   = end;
+		_shared      = shared;
+	}
+
+	/** Process all voices (the default). */
+	inline void unslice_voices() {
+		slice_voices(0, UINT32_MAX, true);
+	}
+
+	/** Return the first voice to process. */
+	inline uint32_t first_voice() const { return _first_voice; }
+
+	/** Return one past the last voice to process for an object with `poly`
+	 * voices. */
+	inline uint32_t end_voice(uint32_t poly) const {
+		return std::min(_end_voice, poly);
+	}
+
+	/** Return true iff work that is not specific to a voice should be done. */
+	inline bool shared() const { return _shared; }
+
+	/** Record the time a block took to run, if it is the slowest so far. */
+	inline void block_time(const BlockImpl* block, uint64_t ns) {
+		if (ns > _slowest_time) {
+			_slowest      = block;
+			_slowest_time = ns;
+		}
+	}
+
+	/** Return the slowest block run in this context since the last reset. */
+	inline const BlockImpl* slowest() const { return _slowest; }
+
+	/** Return the time taken by slowest() in ns. */
+	inline uint64_t slowest_time() const { return _slowest_time; }
+
+	/** Forget the slowest block (at the start of a cycle). */
+	inline void reset_slowest() {
+		_slowest      = NULL;
+		_slowest_time = 0;
+	}
+
 	inline Engine&     engine()   const { return _engine; }
 	inline FrameTime   start()    const { return _start; }
 	inline FrameTime   time()     const { return _start + _offset; }
@@ -113,12 +176,17 @@ protected:
 
 	Raul::RingBuffer* _event_sink; ///< Port updates from process context
 
-	FrameTime   _start;      ///< Start frame of this cycle, timeline relative
-	FrameTime   _end;        ///< End frame of this cycle, timeline relative
-	SampleCount _offset;     ///< Offset into data buffers
-	SampleCount _nframes;    ///< Number of frames past offset to process
-	bool        _realtime;   ///< True iff context is hard realtime
-	bool        _copy;       ///< True iff this is a copy (shared event_sink)
+	FrameTime        _start;        ///< Start frame of this cycle, timeline relative
+	FrameTime        _end;          ///< End frame of this cycle, timeline relative
+	SampleCount      _offset;       ///< Offset into data buffers
+	SampleCount      _nframes;      ///< Number of frames past offset to process
+	uint32_t         _first_voice;  ///< First voice to process
+	uint32_t         _end_voice;    ///< One past the last voice to process
+	bool             _shared;       ///< True iff voice-independent work is done
+	const BlockImpl* _slowest;      ///< Slowest block run (when profiling)
+	uint64_t         _slowest_time; ///< Time taken by _slowest in ns
+	bool             _realtime;     ///< True iff context is hard realtime
+	bool             _copy;         ///< True iff this is a copy (shared event_sink)
 };
 
 } // namespace Server
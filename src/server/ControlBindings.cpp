@@ -16,6 +16,8 @@
 
 #include <math.h>
 
+#include <memory>
+
 #include "ingen/Log.hpp"
 #include "ingen/URIMap.hpp"
 #include "ingen/URIs.hpp"
@@ -131,7 +133,7 @@ ControlBindings::port_binding_changed(ProcessContext& context,
 {
 	const Key key = binding_key(binding);
 	if (key) {
-		_bindings->insert(make_pair(key, port));
+		std::atomic_load(&_bindings)->insert(make_pair(key, port));
 	}
 }
 
@@ -336,7 +338,7 @@ ControlBindings::bind(ProcessContext& context, Key key)
 			return false;
 	}
 
-	_bindings->insert(make_pair(key, _learn_port));
+	std::atomic_load(&_bindings)->insert(make_pair(key, _learn_port));
 
 	uint8_t buf[128];
 	memset(buf, 0, sizeof(buf));
@@ -357,8 +359,8 @@ ControlBindings::remove(const Raul::Path& path)
 {
 	ThreadManager::assert_thread(THREAD_PRE_PROCESS);
 
-	SPtr<Bindings> old_bindings(_bindings);
-	SPtr<Bindings> copy(new Bindings(*_bindings.get()));
+	SPtr<Bindings> old_bindings(std::atomic_load(&_bindings));
+	SPtr<Bindings> copy(new Bindings(*old_bindings.get()));
 
 	for (Bindings::iterator i = copy->begin(); i != copy->end();) {
 		Bindings::iterator next = i;
@@ -370,7 +372,7 @@ ControlBindings::remove(const Raul::Path& path)
 		i = next;
 	}
 
-	_bindings = copy;
+	std::atomic_store(&_bindings, copy);
 	return old_bindings;
 }
 
@@ -379,8 +381,8 @@ ControlBindings::remove(PortImpl* port)
 {
 	ThreadManager::assert_thread(THREAD_PRE_PROCESS);
 
-	SPtr<Bindings> old_bindings(_bindings);
-	SPtr<Bindings> copy(new Bindings(*_bindings.get()));
+	SPtr<Bindings> old_bindings(std::atomic_load(&_bindings));
+	SPtr<Bindings> copy(new Bindings(*old_bindings.get()));
 
 	for (Bindings::iterator i = copy->begin(); i != copy->end();) {
 		Bindings::iterator next = i;
@@ -392,7 +394,7 @@ ControlBindings::remove(PortImpl* port)
 		i = next;
 	}
 
-	_bindings = copy;
+	std::atomic_store(&_bindings, copy);
 	return old_bindings;
 }
 
@@ -400,7 +402,7 @@ void
 ControlBindings::pre_process(ProcessContext& context, Buffer* buffer)
 {
 	uint16_t       value    = 0;
-	SPtr<Bindings> bindings = _bindings;
+	SPtr<Bindings> bindings = std::atomic_load(&_bindings);
 	_feedback->clear();
 
 	Ingen::World*      world = context.engine().world();
@@ -112,7 +112,7 @@ private:
 
 	Engine&        _engine;
 	PortImpl*      _learn_port;
-	SPtr<Bindings> _bindings;
+	SPtr<Bindings> _bindings;  ///< Only with std::atomic_load/atomic_store
 	BufferRef      _feedback;
 	LV2_Atom_Forge _forge;
 };
@@ -0,0 +1,203 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <algorithm>
+
+#include "ingen/Log.hpp"
+#include "ingen/Store.hpp"
+
+#include "BlockImpl.hpp"
+#include "CycleStats.hpp"
+#include "Driver.hpp"
+#include "Engine.hpp"
+
+namespace Ingen {
+namespace Server {
+
+CycleStats::CycleStats(Engine& engine)
+	: _engine(engine)
+	, _worst_ring(sizeof(Cycle) * N_WORST * 4)
+	, _n_cycles(0)
+	, _n_overruns(0)
+	, _n_xruns(0)
+	, _n_late_xruns(0)
+	, _overran(false)
+{
+	for (unsigned i = 0; i < N_WORST; ++i) {
+		_worst[i]  = Cycle{0, 0, 0, 0, NULL, 0, 0};
+		_recent[i] = 0;
+	}
+	for (unsigned i = 0; i < N_BINS; ++i) {
+		_total[i]  = 0;
+		_events[i] = 0;
+		_graph[i]  = 0;
+	}
+}
+
+void
+CycleStats::count(Histogram& histogram, uint64_t ns)
+{
+	unsigned bin = 0;
+	for (uint64_t us = ns / 1000; us > 1 && bin < N_BINS - 1; us >>= 1) {
+		++bin;
+	}
+
+	// Only the process thread writes, so this need not be an atomic increment
+	histogram[bin].store(histogram[bin].load(std::memory_order_relaxed) + 1,
+	                     std::memory_order_relaxed);
+}
+
+void
+CycleStats::record(const Cycle& cycle, SampleCount nframes)
+{
+	count(_total, cycle.total);
+	count(_events, cycle.events);
+	count(_graph, cycle.graph);
+	++_n_cycles;
+
+	const uint64_t period = nframes * 1000000000ull
+		/ _engine.driver()->sample_rate();
+	const bool overran = cycle.total > period;
+	if (overran) {
+		++_n_overruns;
+	}
+	_overran = overran;
+
+	// Replace the best of the worst cycles if this one is worse
+	unsigned best = 0;
+	for (unsigned i = 1; i < N_WORST; ++i) {
+		if (_recent[i] < _recent[best]) {
+			best = i;
+		}
+	}
+	if (cycle.total > _recent[best] &&
+	    _worst_ring.write_space() >= sizeof(cycle)) {
+		_recent[best] = cycle.total;
+		_worst_ring.write(sizeof(cycle), &cycle);
+	}
+}
+
+void
+CycleStats::xrun()
+{
+	++_n_xruns;
+	if (_overran.load()) {
+		++_n_late_xruns;
+	}
+}
+
+static std::string
+bin_name(unsigned bin)
+{
+	if (bin == 0) {
+		return "< 2";
+	} else if (bin == CycleStats::N_BINS - 1) {
+		return ">= " + std::to_string(1ull << bin);
+	}
+	return std::to_string(1ull << bin) + "-" + std::to_string(1ull << (bin + 1));
+}
+
+void
+CycleStats::print_histogram(std::string&     str,
+                            const char*      name,
+                            const Histogram& histogram) const
+{
+	str += (fmt("\n%1% time (us):\n") % name).str();
+	for (unsigned i = 0; i < N_BINS; ++i) {
+		const uint64_t n = histogram[i].load(std::memory_order_relaxed);
+		if (n) {
+			str += (fmt("  %1%: %2%\n") % bin_name(i) % n).str();
+		}
+	}
+}
+
+std::string
+CycleStats::report()
+{
+	// Move newly recorded bad cycles into the worst list
+	Cycle cycle;
+	while (_worst_ring.read(sizeof(cycle), &cycle) == sizeof(cycle)) {
+		unsigned best = 0;
+		for (unsigned i = 1; i < N_WORST; ++i) {
+			if (_worst[i].total < _worst[best].total) {
+				best = i;
+			}
+		}
+		if (cycle.total > _worst[best].total) {
+			_worst[best] = cycle;
+		}
+	}
+
+	const Driver*  driver = _engine.driver();
+	const uint64_t period = driver->block_length() * 1000000ull
+		/ driver->sample_rate();
+
+	std::string str = (fmt("Cycles: %1% (period %2% us)\n")
+	                   % _n_cycles.load() % period).str();
+	str += (fmt("Overruns: %1%\n") % _n_overruns.load()).str();
+	str += (fmt("Xruns: %1% (%2% after an overrun, %3% elsewhere)\n")
+	        % _n_xruns.load()
+	        % _n_late_xruns.load()
+	        % (_n_xruns.load() - _n_late_xruns.load())).str();
+
+	print_histogram(str, "Process", _total);
+	print_histogram(str, "Event", _events);
+	print_histogram(str, "Graph", _graph);
+
+	// Sort worst cycles by descending total time
+	Cycle worst[N_WORST];
+	std::copy(_worst, _worst + N_WORST, worst);
+	std::sort(worst, worst + N_WORST, [](const Cycle& a, const Cycle& b) {
+			return a.total > b.total;
+		});
+
+	// Find the paths of the slowest blocks which still exist
+	std::string paths[N_WORST];
+	{
+		const SPtr<Store> store = _engine.store();
+		SharedLock        lock(store->mutex());
+		for (const auto& s : *store.get()) {
+			for (unsigned i = 0; i < N_WORST; ++i) {
+				if (worst[i].slowest == s.second.get()) {
+					const BlockImpl* const block =
+						dynamic_cast<const BlockImpl*>(s.second.get());
+					if (block && block->id() == worst[i].slowest_id) {
+						paths[i] = block->path();
+					}
+				}
+			}
+		}
+	}
+
+	str += "\nWorst cycles:\n";
+	for (unsigned i = 0; i < N_WORST && worst[i].total; ++i) {
+		const Cycle& c = worst[i];
+		str += (fmt("  %1%: %2% us (events %3% us, graph %4% us)")
+		        % c.time % (c.total / 1000) % (c.events / 1000)
+		        % (c.graph / 1000)).str();
+		if (c.slowest) {
+			str += (fmt(", slowest %1% %2% us")
+			        % (paths[i].empty() ? "(deleted)" : paths[i])
+			        % (c.slowest_time / 1000)).str();
+		}
+		str += "\n";
+	}
+
+	return str;
+}
+
+} // namespace Server
+} // namespace Ingen
@@ -0,0 +1,114 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEN_ENGINE_CYCLESTATS_HPP
+#define INGEN_ENGINE_CYCLESTATS_HPP
+
+#include <atomic>
+#include <string>
+
+#include "raul/Noncopyable.hpp"
+#include "raul/RingBuffer.hpp"
+
+#include "types.hpp"
+
+namespace Ingen {
+
+class Node;
+
+namespace Server {
+
+class Engine;
+
+/** Statistics about how long process cycles take.
+ *
+ * The process thread records the duration of every cycle, split into the
+ * time spent processing events and running the graph, in histograms with
+ * power of two bins.  The worst cycles are kept along with the slowest block
+ * run in them, if profiling is enabled.  Xruns are attributed to Ingen if the
+ * previous cycle took longer than the period, and to something else (JACK
+ * or other clients) otherwise.
+ *
+ * Recording is realtime safe and lock-free.  Reports must only be made from
+ * one (non-realtime) thread at a time.
+ *
+ * \ingroup engine
+ */
+class CycleStats : public Raul::Noncopyable
+{
+public:
+	static const unsigned N_BINS  = 24;   ///< Bins of [2^i, 2^(i+1)) us
+	static const unsigned N_WORST = 8;    ///< Number of worst cycles to keep
+
+	/** Timings of a single cycle, in nanoseconds.
+	 *
+	 * The slowest block may be deleted (and another allocated in its place)
+	 * before a report is made, so its id is recorded along with it, and the
+	 * block is only reported if a block with the same address and id still
+	 * exists.
+	 */
+	struct Cycle {
+		FrameTime        time;          ///< Start of cycle
+		uint64_t         total;         ///< Entire process callback
+		uint64_t         events;        ///< Processing events
+		uint64_t         graph;         ///< Running the root graph
+		const Node*      slowest;       ///< Slowest block, or NULL
+		uint64_t         slowest_id;    ///< BlockImpl::id() of slowest
+		uint64_t         slowest_time;  ///< Time to run slowest block
+	};
+
+	explicit CycleStats(Engine& engine);
+
+	/** Record a cycle (process thread only). */
+	void record(const Cycle& cycle, SampleCount nframes);
+
+	/** Record an xrun (any thread). */
+	void xrun();
+
+	/** Return a human readable report of all statistics.
+	 *
+	 * This takes the store lock to find the slowest blocks, so it must not be
+	 * called by a thread which already holds it.
+	 */
+	std::string report();
+
+private:
+	typedef std::atomic<uint64_t> Histogram[N_BINS];
+
+	static void count(Histogram& histogram, uint64_t ns);
+
+	void print_histogram(std::string&     str,
+	                     const char*      name,
+	                     const Histogram& histogram) const;
+
+	Engine&               _engine;
+	Raul::RingBuffer      _worst_ring;  ///< Bad cycles for report()
+	Cycle                 _worst[N_WORST];  ///< Worst cycles (report() only)
+	uint64_t              _recent[N_WORST];  ///< Worst times (process only)
+	Histogram             _total;
+	Histogram             _events;
+	Histogram             _graph;
+	std::atomic<uint64_t> _n_cycles;
+	std::atomic<uint64_t> _n_overruns;  ///< Cycles longer than the period
+	std::atomic<uint64_t> _n_xruns;  ///< All xruns
+	std::atomic<uint64_t> _n_late_xruns;  ///< Xruns after an overrun
+	std::atomic<bool>     _overran;  ///< True iff last cycle overran
+};
+
+} // namespace Server
+} // namespace Ingen
+
+#endif // INGEN_ENGINE_CYCLESTATS_HPP
@@ -27,6 +27,7 @@ namespace Raul { class Path; }
 namespace Ingen {
 namespace Server {
 
+class CycleStats;
 class DuplexPort;
 class EnginePort;
 
@@ -93,6 +94,12 @@ public:
 	/** Return the current frame time (running counter) */
 	virtual SampleCount frame_time()  const = 0;
 
+	/** Return the real-time priority of the process thread, or -1. */
+	virtual int real_time_priority() const { return -1; }
+
+	/** Return statistics about process cycles, or NULL if not measured. */
+	virtual CycleStats* cycle_stats() { return NULL; }
+
 	/** Append time events for this cycle to `buffer`. */
 	virtual void append_time_events(ProcessContext& context,
 	                                Buffer&         buffer) = 0;
@@ -106,10 +106,11 @@ DuplexPort::inherit_neighbour(const PortImpl*       port,
 			add.insert(std::make_pair(uris.lv2_maximum, port->maximum()));
 		}
 	} else if (_type == PortType::ATOM) {
-		for (Resource::Properties::const_iterator i = port->properties().find(
-			     uris.atom_supports);
-		     i != port->properties().end() && i->first == uris.atom_supports;
-		     ++i) {
+		typedef Resource::Properties::const_iterator iterator;
+		const Resource::Properties          props = port->properties();
+		const std::pair<iterator, iterator> range =
+			props.equal_range(uris.atom_supports);
+		for (iterator i = range.first; i != range.second; ++i) {
 			set_property(i->first, i->second);
 			add.insert(*i);
 		}
@@ -213,9 +214,11 @@ DuplexPort::post_process(Context& context)
 }
 
 SampleCount
-DuplexPort::next_value_offset(SampleCount offset, SampleCount end) const
+DuplexPort::next_value_offset(const Context& context,
+                              SampleCount    offset,
+                              SampleCount    end) const
 {
-	return OutputPort::next_value_offset(offset, end);
+	return OutputPort::next_value_offset(context, offset, end);
 }
 
 void
@@ -18,6 +18,8 @@
 
 #include <sys/mman.h>
 
+#include <algorithm>
+#include <chrono>
 #include <limits>
 
 #include "lv2/lv2plug.in/ns/ext/buf-size/buf-size.h"
@@ -45,6 +47,7 @@
 #include "PostProcessor.hpp"
 #include "PreProcessor.hpp"
 #include "ProcessContext.hpp"
+#include "ProcessSlave.hpp"
 #include "ThreadManager.hpp"
 #include "Worker.hpp"
 #ifdef HAVE_SOCKET
@@ -62,13 +65,14 @@ bool                      ThreadManager::single_threaded(true);
 Engine::Engine(Ingen::World* world)
 	: _world(world)
 	, _block_factory(new BlockFactory(world))
-	, _broadcaster(new Broadcaster())
+	, _broadcaster(new Broadcaster(world->uri_map(), world->uris()))
 	, _buffer_factory(new BufferFactory(*this, world->uris()))
 	, _control_bindings(NULL)
 	, _event_writer(new EventWriter(*this))
 	, _maid(new Raul::Maid())
 	, _options(new LV2Options(world->uris()))
-	, _pre_processor(new PreProcessor())
+	, _pre_processor(new PreProcessor(
+		  std::max(0, world->conf().option("pre-threads").get<int32_t>())))
 	, _post_processor(new PostProcessor(*this))
 	, _root_graph(NULL)
 	, _worker(new Worker(world->log(), event_queue_size()))
@@ -76,6 +80,11 @@ Engine::Engine(Ingen::World* world)
 	, _process_context(*this)
 	, _rand_engine(0)
 	, _uniform_dist(0.0f, 1.0f)
+	, _events_time(0)
+	, _graph_time(0)
+	, _profiling(world->conf().option("profile").get<int32_t>())
+	, _event_budget(std::max(
+		  1, std::min(100, world->conf().option("event-budget").get<int32_t>())))
 	, _quit_flag(false)
 	, _direct_driver(true)
 {
@@ -109,7 +118,7 @@ Engine::~Engine()
 	_post_processor->set_end_time(end);
 	_post_processor->process();
 	while (!_pre_processor->empty()) {
-		_pre_processor->process(_process_context, *_post_processor, 1);
+		_pre_processor->process(_process_context, *_post_processor);
 		_post_processor->process();
 	}
 
@@ -247,6 +256,13 @@ Engine::activate()
 		_root_graph = ev.graph();
 	}
 
+	// Launch slave threads to help run the graph in parallel
+	const int32_t n_threads = _world->conf().option("threads").get<int32_t>();
+	for (int32_t i = 1; i < n_threads; ++i) {
+		_process_slaves.push_back(
+			new ProcessSlave(*this, i, _driver->real_time_priority()));
+	}
+
 	_driver->activate();
 	_root_graph->enable();
 
@@ -266,6 +282,11 @@ Engine::deactivate()
 		_root_graph->deactivate();
 	}
 
+	for (ProcessSlave* slave : _process_slaves) {
+		delete slave;
+	}
+	_process_slaves.clear();
+
 	ThreadManager::single_threaded = true;
 }
 
@@ -280,14 +301,27 @@ Engine::run(uint32_t sample_count)
 
 	post_processor()->set_end_time(_process_context.end());
 
+	typedef std::chrono::steady_clock Clock;
+
 	// Process events that came in during the last cycle
 	// (Aiming for jitter-free 1 block event latency, ideally)
-	const unsigned n_processed_events = process_events();
+	const Clock::time_point start              = Clock::now();
+	const unsigned          n_processed_events = process_events();
+	const Clock::time_point events_end         = Clock::now();
+
+	_events_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		events_end - start).count();
 
 	// Run root graph
 	if (_root_graph) {
 		_root_graph->process(_process_context);
 
+		_graph_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			Clock::now() - events_end).count();
+		if (profiling()) {
+			_root_graph->add_run_time(_graph_time);
+		}
+
 		// Emit control binding feedback
 		control_bindings()->post_process(
 			_process_context, _root_graph->port_impl(1)->buffer(0).get());
@@ -296,6 +330,23 @@ Engine::run(uint32_t sample_count)
 	return n_processed_events;
 }
 
+const BlockImpl*
+Engine::take_slowest_block(uint64_t& time)
+{
+	const BlockImpl* slowest = _process_context.slowest();
+	time = _process_context.slowest_time();
+	_process_context.reset_slowest();
+	for (ProcessSlave* slave : _process_slaves) {
+		ProcessContext& context = slave->context();
+		if (context.slowest_time() > time) {
+			slowest = context.slowest();
+			time    = context.slowest_time();
+		}
+		context.reset_slowest();
+	}
+	return slowest;
+}
+
 bool
 Engine::pending_events()
 {
@@ -311,9 +362,68 @@ Engine::enqueue_event(Event* ev)
 unsigned
 Engine::process_events()
 {
-	const size_t MAX_EVENTS_PER_CYCLE = _process_context.nframes() / 8;
+	/* Spend at most a fraction of the period executing events, so a flood of
+	   events is spread over several cycles rather than causing an xrun. */
+	const uint64_t period = _process_context.nframes() * 1000000000ull
+		/ _driver->sample_rate();
+
 	return _pre_processor->process(
-		_process_context, *_post_processor, MAX_EVENTS_PER_CYCLE);
+		_process_context, *_post_processor, period * _event_budget / 100);
+}
+
+void
+Engine::emit_notifications(FrameTime end)
+{
+	if (!pending_notifications()) {
+		return;
+	}
+
+	/* Send updates from every thread as a single bundle, in time order.  Each
+	   ring is ordered, so repeatedly emit from the context with the earliest
+	   notification up to the time of the next one in any other context. */
+	MonitorUpdates updates(*_broadcaster);
+	while (true) {
+		Context*  first      = NULL;
+		FrameTime first_time = end;
+		FrameTime next_time  = end;
+		auto      consider   = [&](Context& context) {
+			FrameTime time;
+			if (!context.next_notification_time(time) || time >= end) {
+				return;
+			} else if (!first || time < first_time) {
+				next_time  = first_time;
+				first      = &context;
+				first_time = time;
+			} else if (time < next_time) {
+				next_time = time;
+			}
+		};
+
+		consider(_process_context);
+		for (ProcessSlave* slave : _process_slaves) {
+			consider(slave->context());
+		}
+
+		if (!first ||
+		    !first->emit_notifications(std::max(next_time, first_time + 1),
+		                               updates)) {
+			break;
+		}
+	}
+}
+
+bool
+Engine::pending_notifications()
+{
+	if (_process_context.pending_notifications()) {
+		return true;
+	}
+	for (ProcessSlave* slave : _process_slaves) {
+		if (slave->context().pending_notifications()) {
+			return true;
+		}
+	}
+	return false;
 }
 
 void
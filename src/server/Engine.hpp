@@ -17,7 +17,9 @@
 #ifndef INGEN_ENGINE_ENGINE_HPP
 #define INGEN_ENGINE_ENGINE_HPP
 
+#include <atomic>
 #include <random>
+#include <vector>
 
 #include <boost/utility.hpp>
 
@@ -26,6 +28,7 @@
 #include "ingen/ingen.h"
 #include "ingen/types.hpp"
 
+#include "PreProcessContext.hpp"
 #include "ProcessContext.hpp"
 
 namespace Raul { class Maid; }
@@ -38,6 +41,7 @@ class World;
 namespace Server {
 
 class BlockFactory;
+class BlockImpl;
 class Broadcaster;
 class BufferFactory;
 class ControlBindings;
@@ -49,6 +53,7 @@ class LV2Options;
 class PostProcessor;
 class PreProcessor;
 class ProcessContext;
+class ProcessSlave;
 class SocketListener;
 class Worker;
 
@@ -88,12 +93,22 @@ public:
 
 	SampleCount event_time();
 
-	/** Enqueue an event to be processed (non-realtime threads only). */
+	/** Enqueue an event to be processed (non-realtime threads only).
+	 *
+	 * Several events may be enqueued at once by linking them with
+	 * Event::next(), see PreProcessor::event().
+	 */
 	void enqueue_event(Event* ev);
 
 	/** Process events (process thread only). */
 	unsigned process_events();
 
+	/** Emit notifications from all process contexts up to `end`. */
+	void emit_notifications(FrameTime end);
+
+	/** Return true iff any process context has pending notifications. */
+	bool pending_notifications();
+
 	bool is_process_context(const Context& context) const {
 		return &context == &_process_context;
 	}
@@ -114,8 +129,37 @@ public:
 
 	ProcessContext& process_context() { return _process_context; }
 
+	/** State shared by events being pre-processed (pre-processor only). */
+	PreProcessContext& pre_process_context() { return _pre_process_context; }
+
+	typedef std::vector<ProcessSlave*> ProcessSlaves;
+
+	/** Threads which help the process thread run graphs in parallel. */
+	const ProcessSlaves& process_slaves() const { return _process_slaves; }
+
 	SPtr<Store> store() const;
 
+	/** Return true iff the processing time of blocks is being measured. */
+	bool profiling() const {
+		return _profiling.load(std::memory_order_relaxed);
+	}
+
+	/** Enable or disable measuring the processing time of blocks. */
+	void set_profiling(bool profiling) { _profiling = profiling; }
+
+	/** Time spent processing events in the last cycle in ns. */
+	uint64_t events_time() const { return _events_time; }
+
+	/** Time spent running the root graph in the last cycle in ns. */
+	uint64_t graph_time() const { return _graph_time; }
+
+	/** Return the slowest block run by any process thread since the last
+	 * call, and set `time` to how long it took (process thread only).
+	 *
+	 * Blocks are only timed when profiling, otherwise this returns NULL.
+	 */
+	const BlockImpl* take_slowest_block(uint64_t& time);
+
 	size_t event_queue_size() const;
 
 private:
@@ -135,11 +179,18 @@ private:
 	Worker*          _worker;
 	SocketListener*  _listener;
 
-	ProcessContext _process_context;
+	PreProcessContext _pre_process_context;
+	ProcessContext    _process_context;
+	ProcessSlaves     _process_slaves;
 
 	std::mt19937                          _rand_engine;
 	std::uniform_real_distribution<float> _uniform_dist;
 
+	uint64_t          _events_time;
+	uint64_t          _graph_time;
+	std::atomic<bool> _profiling;
+	unsigned          _event_budget;  ///< Percentage of period for events
+
 	bool _quit_flag;
 	bool _direct_driver;
 };
@@ -28,6 +28,7 @@
 #include "ingen/Status.hpp"
 #include "ingen/types.hpp"
 
+#include "EventPool.hpp"
 #include "types.hpp"
 
 namespace Ingen {
@@ -51,8 +52,25 @@ class ProcessContext;
 class Event : public Raul::Deletable, public Raul::Noncopyable
 {
 public:
+	/** How an event affects the execution of the events that follow it. */
+	enum class Execution {
+		NORMAL,  ///< Execute normally
+		BLOCK,   ///< Start an atomic bundle
+		UNBLOCK  ///< End an atomic bundle
+	};
+
 	virtual ~Event() {}
 
+	/** Allocate an event from the EventPool. */
+	static void* operator new(size_t size) {
+		return EventPool::allocate(size);
+	}
+
+	/** Return an event to the EventPool. */
+	static void operator delete(void* ptr, size_t size) {
+		EventPool::deallocate(ptr, size);
+	}
+
 	/** Pre-process event before execution (non-realtime). */
 	virtual bool pre_process() = 0;
 
@@ -62,6 +80,52 @@ public:
 	/** Post-process event after execution (non-realtime). */
 	virtual void post_process() = 0;
 
+	/** Return how this event affects the execution of following events.
+	 *
+	 * All events between a BLOCK and the matching UNBLOCK are executed
+	 * together in a single process cycle, once they have all been prepared.
+	 */
+	virtual Execution get_execution() const { return Execution::NORMAL; }
+
+	/** Return true iff this event may be pre-processed concurrently.
+	 *
+	 * Such events may be pre-processed in a worker thread, at the same time
+	 * as earlier events whose scope() does not overlap with this one.  They
+	 * must only read the store, with its lock held, and must only modify
+	 * objects within their scope.
+	 */
+	virtual bool is_concurrent() const { return false; }
+
+	/** Return the root of all objects this event may affect.
+	 *
+	 * By default this is the root path, so the event conflicts with every
+	 * other event and is never pre-processed concurrently with them.
+	 */
+	virtual Raul::Path scope() const { return Raul::Path("/"); }
+
+	/** Return true iff a later event may make this one redundant. */
+	virtual bool can_be_superseded() const { return false; }
+
+	/** Return true iff this event is made redundant by `ev`, a later event.
+	 *
+	 * If so, and no event in between may affect the same objects, this event
+	 * may be superseded (see supersede()).
+	 */
+	virtual bool is_superseded_by(const Event& ev) const { return false; }
+
+	/** Mark this event as superseded by a later event.
+	 *
+	 * A superseded event is not performed at all, but still responds to its
+	 * client as if it succeeded.  This is only called on events before they
+	 * are pre-processed, if is_superseded_by() is true.
+	 */
+	virtual void supersede() {}
+
+	/** Return true iff the client that sent this event expects a response. */
+	inline bool wants_response() const {
+		return _request_client && _request_id;
+	}
+
 	/** Return true iff this event has been pre-processed. */
 	inline bool is_prepared() const { return _status != Status::NOT_PREPARED; }
 
@@ -0,0 +1,112 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+#include "EventPool.hpp"
+
+namespace Ingen {
+namespace Server {
+
+/** Granularity of pooled sizes, larger than any alignment requirement. */
+static const size_t GRANULARITY = 64;
+
+/** Number of size classes, events larger than this are not pooled. */
+static const size_t N_CLASSES = 64;
+
+namespace {
+
+/** A freed block, which is reused as a free list link. */
+struct Block {
+	Block* next;
+};
+
+/** Free list of blocks of a single size.
+ *
+ * A mutex is used since several threads may allocate at once, which would
+ * make a lock-free stack susceptible to the ABA problem.  It is only held
+ * for a few instructions, so is practically never contended.
+ */
+struct SizeClass {
+	std::mutex mutex;
+	Block*     head;
+};
+
+SizeClass           size_classes[N_CLASSES];
+std::atomic<size_t> n_system_allocations(0);
+std::atomic<size_t> n_pool_reuses(0);
+
+} // namespace
+
+static inline size_t
+size_class(size_t size)
+{
+	return (size + GRANULARITY - 1) / GRANULARITY;
+}
+
+void*
+EventPool::allocate(size_t size)
+{
+	const size_t c = size_class(size);
+	if (c < N_CLASSES) {
+		SizeClass& sc = size_classes[c];
+		std::lock_guard<std::mutex> lock(sc.mutex);
+		if (sc.head) {
+			Block* const block = sc.head;
+			sc.head = block->next;
+			++n_pool_reuses;
+			return block;
+		}
+	}
+
+	++n_system_allocations;
+	return ::operator new(c < N_CLASSES ? c * GRANULARITY : size);
+}
+
+void
+EventPool::deallocate(void* ptr, size_t size)
+{
+	const size_t c = size_class(size);
+	if (!ptr) {
+		return;
+	} else if (c >= N_CLASSES) {
+		::operator delete(ptr);
+		return;
+	}
+
+	SizeClass&                  sc    = size_classes[c];
+	Block* const                block = static_cast<Block*>(ptr);
+	std::lock_guard<std::mutex> lock(sc.mutex);
+	block->next = sc.head;
+	sc.head     = block;
+}
+
+size_t
+EventPool::n_allocations()
+{
+	return n_system_allocations.load();
+}
+
+size_t
+EventPool::n_reuses()
+{
+	return n_pool_reuses.load();
+}
+
+} // namespace Server
+} // namespace Ingen
@@ -0,0 +1,60 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEN_ENGINE_EVENTPOOL_HPP
+#define INGEN_ENGINE_EVENTPOOL_HPP
+
+#include <stddef.h>
+
+namespace Ingen {
+namespace Server {
+
+/** Recycling allocator for events.
+ *
+ * Every message from a client creates an event, which is deleted once it has
+ * been post-processed, so they are allocated and freed at a high rate.  This
+ * keeps freed memory in free lists by size and reuses it, so once the pool
+ * has grown to fit the peak number of events in flight, creating an event
+ * does not touch the system allocator.  Memory is never returned.
+ *
+ * This is safe to use from any non-realtime thread.
+ *
+ * \ingroup engine
+ */
+class EventPool
+{
+public:
+	/** Allocate memory for an event of the given size. */
+	static void* allocate(size_t size);
+
+	/** Free memory allocated with allocate() for later reuse. */
+	static void deallocate(void* ptr, size_t size);
+
+	/** Return the number of allocations made from the system so far.
+	 *
+	 * This only counts memory for event objects.  Anything an event allocates
+	 * itself, like property maps and URIs, comes from the system allocator.
+	 */
+	static size_t n_allocations();
+
+	/** Return the number of allocations served by reusing memory so far. */
+	static size_t n_reuses();
+};
+
+} // namespace Server
+} // namespace Ingen
+
+#endif // INGEN_ENGINE_EVENTPOOL_HPP
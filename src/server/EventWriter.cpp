@@ -28,11 +28,20 @@ namespace Server {
 EventWriter::EventWriter(Engine& engine)
 	: _engine(engine)
 	, _request_id(0)
+	, _bundle_depth(0)
+	, _bundle_head(NULL)
+	, _bundle_tail(NULL)
 {
 }
 
 EventWriter::~EventWriter()
 {
+	// Drop the events of any bundle that was never ended
+	for (Event* ev = _bundle_head; ev;) {
+		Event* const next = ev->next();
+		delete ev;
+		ev = next;
+	}
 }
 
 SampleCount
@@ -41,18 +50,67 @@ EventWriter::now() const
 	return _engine.event_time();
 }
 
+void
+EventWriter::enqueue(Event* ev)
+{
+	if (_bundle_depth == 0) {
+		_engine.enqueue_event(ev);
+	} else if (_bundle_tail) {
+		_bundle_tail->next(ev);
+		_bundle_tail = ev;
+	} else {
+		_bundle_head = _bundle_tail = ev;
+	}
+}
+
 void
 EventWriter::set_response_id(int32_t id)
 {
 	_request_id = id;
 }
 
+void
+EventWriter::bundle_begin()
+{
+	++_bundle_depth;
+	enqueue(
+		new Events::Mark(_engine, _respondee, _request_id, now(),
+		                 Events::Mark::Type::BUNDLE_START));
+}
+
+void
+EventWriter::bundle_end()
+{
+	if (_bundle_depth == 0) {
+		return;  // Unbalanced end, ignore to avoid confusing other clients
+	}
+
+	enqueue(
+		new Events::Mark(_engine, _respondee, _request_id, now(),
+		                 Events::Mark::Type::BUNDLE_END));
+
+	if (--_bundle_depth == 0) {
+		/* Enqueue the whole bundle at once, so it never holds up other
+		   clients while this one is still sending it. */
+		_engine.enqueue_event(_bundle_head);
+		_bundle_head = _bundle_tail = NULL;
+	}
+}
+
+void
+EventWriter::end_bundles()
+{
+	while (_bundle_depth > 0) {
+		bundle_end();
+	}
+}
+
 void
 EventWriter::put(const Raul::URI&            uri,
                  const Resource::Properties& properties,
                  const Resource::Graph       ctx)
 {
-	_engine.enqueue_event(
+	enqueue(
 		new Events::Delta(_engine, _respondee, _request_id, now(),
 		                  Events::Delta::Type::PUT, ctx, uri, properties));
 }
@@ -62,7 +120,7 @@ EventWriter::delta(const Raul::URI&            uri,
                    const Resource::Properties& remove,
                    const Resource::Properties& add)
 {
-	_engine.enqueue_event(
+	enqueue(
 		new Events::Delta(_engine, _respondee, _request_id, now(),
 		                  Events::Delta::Type::PATCH, Resource::Graph::DEFAULT,
 		                  uri, add, remove));
@@ -72,7 +130,7 @@ void
 EventWriter::copy(const Raul::URI& old_uri,
                   const Raul::URI& new_uri)
 {
-	_engine.enqueue_event(
+	enqueue(
 		new Events::Copy(_engine, _respondee, _request_id, now(),
 		                 old_uri, new_uri));
 }
@@ -81,7 +139,7 @@ void
 EventWriter::move(const Raul::Path& old_path,
                   const Raul::Path& new_path)
 {
-	_engine.enqueue_event(
+	enqueue(
 		new Events::Move(_engine, _respondee, _request_id, now(),
 		                 old_path, new_path));
 }
@@ -89,7 +147,7 @@ EventWriter::move(const Raul::Path& old_path,
 void
 EventWriter::del(const Raul::URI& uri)
 {
-	_engine.enqueue_event(
+	enqueue(
 		new Events::Delete(_engine, _respondee, _request_id, now(), uri));
 }
 
@@ -97,7 +155,7 @@ void
 EventWriter::connect(const Raul::Path& tail_path,
                      const Raul::Path& head_path)
 {
-	_engine.enqueue_event(
+	enqueue(
 		new Events::Connect(_engine, _respondee, _request_id, now(),
 		                    tail_path, head_path));
 
@@ -107,7 +165,7 @@ void
 EventWriter::disconnect(const Raul::Path& src,
                         const Raul::Path& dst)
 {
-	_engine.enqueue_event(
+	enqueue(
 		new Events::Disconnect(_engine, _respondee, _request_id, now(),
 		                       src, dst));
 }
@@ -116,7 +174,7 @@ void
 EventWriter::disconnect_all(const Raul::Path& graph,
                             const Raul::Path& path)
 {
-	_engine.enqueue_event(
+	enqueue(
 		new Events::DisconnectAll(_engine, _respondee, _request_id, now(),
 		                          graph, path));
 }
@@ -131,16 +189,16 @@ EventWriter::set_property(const Raul::URI& uri,
 
 	Resource::Properties add{{ predicate, value }};
 
-	_engine.enqueue_event(
+	enqueue(
 		new Events::Delta(_engine, _respondee, _request_id, now(),
 		                  Events::Delta::Type::SET, Resource::Graph::DEFAULT,
-		                  uri, add, remove));
+		                  uri, std::move(add), std::move(remove)));
 }
 
 void
 EventWriter::get(const Raul::URI& uri)
 {
-	_engine.enqueue_event(
+	enqueue(
 		new Events::Get(_engine, _respondee, _request_id, now(), uri));
 }
 
@@ -31,8 +31,12 @@ namespace Ingen {
 namespace Server {
 
 class Engine;
+class Event;
 
 /** An Interface that creates and enqueues Events for the Engine to execute.
+ *
+ * Events in an atomic bundle are kept until the bundle ends, then enqueued
+ * together, so a client sending a bundle never holds up other clients.
  */
 class EventWriter : public Interface
 {
@@ -52,9 +56,12 @@ public:
 
 	virtual void set_response_id(int32_t id);
 
-	virtual void bundle_begin() {}
+	virtual void bundle_begin();
 
-	virtual void bundle_end() {}
+	virtual void bundle_end();
+
+	/** End any bundles left open, e.g. when a client disconnects. */
+	void end_bundles();
 
 	virtual void put(const Raul::URI&            path,
 	                 const Resource::Properties& properties,
@@ -95,9 +102,15 @@ protected:
 	Engine&         _engine;
 	SPtr<Interface> _respondee;
 	int32_t         _request_id;
+	unsigned        _bundle_depth;
+	Event*          _bundle_head;  ///< First event of the current bundle
+	Event*          _bundle_tail;  ///< Last event of the current bundle
 
 private:
 	SampleCount now() const;
+
+	/** Enqueue `ev`, or append it to the current bundle if there is one. */
+	void enqueue(Event* ev);
 };
 
 } // namespace Server
@@ -14,9 +14,12 @@
   along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
 #include <cassert>
 #include <unordered_map>
+#include <vector>
 
+#include "ingen/Configuration.hpp"
 #include "ingen/Log.hpp"
 #include "ingen/URIs.hpp"
 #include "ingen/World.hpp"
@@ -31,6 +34,7 @@
 #include "GraphImpl.hpp"
 #include "GraphPlugin.hpp"
 #include "PortImpl.hpp"
+#include "ProcessSlave.hpp"
 #include "ThreadManager.hpp"
 
 using namespace std;
@@ -38,6 +42,9 @@ using namespace std;
 namespace Ingen {
 namespace Server {
 
+/** Maximum number of slaves to run one graph, the size of a whipped mask. */
+static const size_t MAX_SLAVES = 64;
+
 GraphImpl::GraphImpl(Engine&             engine,
                      const Raul::Symbol& symbol,
                      uint32_t            poly,
@@ -53,6 +60,7 @@ GraphImpl::GraphImpl(Engine&             engine,
 	, _poly_pre(internal_poly)
 	, _poly_process(internal_poly)
 	, _compiled_graph(NULL)
+	, _n_holes(0)
 	, _process(false)
 {
 	assert(internal_poly >= 1);
@@ -234,13 +242,89 @@ void
 GraphImpl::run(ProcessContext& context)
 {
 	if (_compiled_graph && _compiled_graph->size() > 0) {
-		// Run all blocks
-		for (size_t i = 0; i < _compiled_graph->size(); ++i) {
-			(*_compiled_graph)[i].block()->process(context);
+		if (!_parent &&
+		    !_engine.process_slaves().empty() &&
+		    _compiled_graph->parallelism() > 1) {
+			run_parallel(context);
+		} else if (_poly_process > 1 &&
+		           !_engine.process_slaves().empty() &&
+		           _compiled_graph->has_voice_blocks()) {
+			run_voices(context);
+		} else {
+			// Run all blocks
+			for (size_t i = 0; i < _compiled_graph->size(); ++i) {
+				const CompiledBlock& block = (*_compiled_graph)[i];
+				block.process(context);
+			}
+		}
+	}
+}
+
+void
+GraphImpl::run_parallel(ProcessContext& context)
+{
+	const Engine::ProcessSlaves& slaves   = _engine.process_slaves();
+	CompiledGraph* const         cg       = _compiled_graph;
+	const size_t                 n_slaves = std::min(
+		std::min(slaves.size(), size_t(cg->parallelism() - 1)), MAX_SLAVES);
+
+	// Start slaves working on the graph
+	uint64_t whipped = 0;
+	cg->reset();
+	for (size_t i = 0; i < n_slaves; ++i) {
+		if (slaves[i]->whip(cg, context)) {
+			whipped |= uint64_t(1) << i;
+		}
+	}
+
+	// Work on the graph in this thread as well
+	cg->work(context);
+
+	/* Every block has been executed, but slaves may not have noticed yet.
+	   Wait for them to return so the graph can be safely replaced. */
+	for (size_t i = 0; i < n_slaves; ++i) {
+		if (whipped & (uint64_t(1) << i)) {
+			slaves[i]->finish();
 		}
 	}
 }
 
+void
+GraphImpl::run_voices(ProcessContext& context)
+{
+	const Engine::ProcessSlaves& slaves   = _engine.process_slaves();
+	CompiledGraph* const         cg       = _compiled_graph;
+	const size_t                 n_slaves = std::min(
+		std::min(slaves.size(), size_t(_poly_process - 1)), MAX_SLAVES);
+
+	// Run blocks that per-voice blocks depend on
+	cg->run_before_voices(context);
+
+	/* Start any idle slaves running voices.  Slaves may be busy with the
+	   parent graph or another subgraph, in which case this thread simply
+	   runs more voices itself. */
+	uint64_t whipped = 0;
+	cg->reset_voices(_poly_process);
+	for (size_t i = 0; i < n_slaves; ++i) {
+		if (slaves[i]->whip(cg, context)) {
+			whipped |= uint64_t(1) << i;
+		}
+	}
+
+	// Run voices in this thread as well
+	cg->work(context);
+
+	// Wait for slaves to finish the voices they claimed
+	for (size_t i = 0; i < n_slaves; ++i) {
+		if (whipped & (uint64_t(1) << i)) {
+			slaves[i]->finish();
+		}
+	}
+
+	// Run blocks that depend on per-voice blocks
+	cg->run_after_voices(context);
+}
+
 void
 GraphImpl::set_buffer_size(Context&       context,
                            BufferFactory& bufs,
@@ -262,12 +346,127 @@ GraphImpl::add_block(BlockImpl& block)
 {
 	ThreadManager::assert_thread(THREAD_PRE_PROCESS);
 	_blocks.push_front(block);
+
+	// New blocks have no arcs yet, so can go anywhere in the order
+	block.order_index(_order.size());
+	_order.push_back(&block);
 }
 
 void
 GraphImpl::remove_block(BlockImpl& block)
 {
 	_blocks.erase(_blocks.iterator_to(block));
+
+	// Leave a hole rather than shifting every later block down
+	assert(_order[block.order_index()] == &block);
+	_order[block.order_index()] = NULL;
+	if (++_n_holes > _order.size() / 2) {
+		compact_order();
+	}
+}
+
+void
+GraphImpl::compact_order()
+{
+	uint32_t n = 0;
+	for (BlockImpl* b : _order) {
+		if (b) {
+			b->order_index(n);
+			_order[n++] = b;
+		}
+	}
+	_order.resize(n);
+	_n_holes = 0;
+}
+
+void
+GraphImpl::reorder(BlockImpl* tail, BlockImpl* head)
+{
+	ThreadManager::assert_thread(THREAD_PRE_PROCESS);
+
+	const uint32_t lower = head->order_index();
+	const uint32_t upper = tail->order_index();
+	if (upper < lower) {
+		return;  // Tail already runs first
+	}
+
+	/* This is the algorithm from Pearce and Kelly, "A Dynamic Topological Sort
+	   Algorithm for Directed Acyclic Graphs".  Find the blocks between head
+	   and tail that depend on head, and those that tail depends on. */
+	Order forward;
+	Order backward;
+	const bool acyclic = order_search(head, upper, true, tail, forward);
+	if (acyclic) {
+		order_search(tail, lower, false, NULL, backward);
+	}
+
+	for (BlockImpl* b : forward) {
+		b->traversed(false);
+	}
+	for (BlockImpl* b : backward) {
+		b->traversed(false);
+	}
+
+	if (!acyclic) {
+		// Feedback loop, no valid order exists so leave it as is
+		return;
+	}
+
+	const auto by_order = [](const BlockImpl* a, const BlockImpl* b) {
+		return a->order_index() < b->order_index();
+	};
+	std::sort(forward.begin(), forward.end(), by_order);
+	std::sort(backward.begin(), backward.end(), by_order);
+
+	// Reuse the positions of both sets, with tail's providers first
+	std::vector<uint32_t> slots;
+	slots.reserve(forward.size() + backward.size());
+	for (const BlockImpl* b : backward) {
+		slots.push_back(b->order_index());
+	}
+	for (const BlockImpl* b : forward) {
+		slots.push_back(b->order_index());
+	}
+	std::sort(slots.begin(), slots.end());
+
+	size_t s = 0;
+	for (BlockImpl* b : backward) {
+		b->order_index(slots[s]);
+		_order[slots[s++]] = b;
+	}
+	for (BlockImpl* b : forward) {
+		b->order_index(slots[s]);
+		_order[slots[s++]] = b;
+	}
+}
+
+bool
+GraphImpl::order_search(BlockImpl*       block,
+                        uint32_t         bound,
+                        bool             forward,
+                        const BlockImpl* stop,
+                        Order&           found)
+{
+	Order stack(1, block);
+	block->traversed(true);
+	found.push_back(block);
+	while (!stack.empty()) {
+		BlockImpl* const b = stack.back();
+		stack.pop_back();
+
+		for (BlockImpl* n : forward ? b->dependants() : b->providers()) {
+			if (n == stop) {
+				return false;
+			} else if (!n->traversed() &&
+			           (forward ? n->order_index() < bound
+			                    : n->order_index() > bound)) {
+				n->traversed(true);
+				found.push_back(n);
+				stack.push_back(n);
+			}
+		}
+	}
+	return true;
 }
 
 void
@@ -353,20 +552,107 @@ GraphImpl::build_ports_array()
 	return result;
 }
 
-static inline void
-compile_recursive(BlockImpl* n, CompiledGraph* output)
+void
+GraphImpl::compile_levels(CompiledGraph* compiled_graph)
 {
-	if (n == NULL || n->traversed())
-		return;
+	/* Find the level of each block, one past the deepest of its providers.
+	   Providers not seen yet are later in the order (a feedback loop), and
+	   are ignored as they are when executing blocks in parallel.  Levels are
+	   kept in the blocks themselves, so compiling does not allocate. */
+	static const uint32_t UNSEEN = UINT32_MAX;
+	for (const auto& cb : *compiled_graph) {
+		cb.block()->mark(UNSEEN);
+	}
+	for (const auto& cb : *compiled_graph) {
+		uint32_t level = 0;
+		for (const auto& p : cb.block()->providers()) {
+			if (p->mark() != UNSEEN) {
+				level = std::max(level, p->mark() + 1);
+			}
+		}
+		cb.block()->mark(level);
+	}
 
-	n->traversed(true);
-	assert(output != NULL);
+	// Sort blocks by level (still a valid order for serial execution)
+	std::stable_sort(compiled_graph->begin(), compiled_graph->end(),
+	                 [](const CompiledBlock& a, const CompiledBlock& b) {
+		                 return a.block()->mark() < b.block()->mark();
+	                 });
+
+	// Record where each level ends
+	for (uint32_t i = 0; i < compiled_graph->size(); ++i) {
+		if (i + 1 == compiled_graph->size() ||
+		    ((*compiled_graph)[i].block()->mark() !=
+		     (*compiled_graph)[i + 1].block()->mark())) {
+			compiled_graph->_level_ends.push_back(i + 1);
+		}
+	}
 
-	for (auto& p : n->providers())
-		if (!p->traversed())
-			compile_recursive(p, output);
+	/* Keep the sorted order, so blocks stay at their order index in the
+	   compiled graph, and the next sort has little to do. */
+	for (uint32_t i = 0; i < compiled_graph->size(); ++i) {
+		BlockImpl* const block = (*compiled_graph)[i].block();
+		block->order_index(i);
+		_order[i] = block;
+	}
+}
+
+void
+GraphImpl::compile_voices(CompiledGraph* compiled_graph)
+{
+	enum Stage { BEFORE, VOICE, AFTER, UNSEEN };
+
+	/* Classify blocks in order.  A block with independent voices can be run
+	   per voice if all its providers are run before voices or per voice.
+	   Anything depending on a per-voice block must wait until every voice is
+	   finished.  Providers not seen yet are later in the order (a feedback
+	   loop), so the block is conservatively run after voices.  The stage of
+	   each block is kept in the block itself while compiling. */
+	for (const auto& cb : *compiled_graph) {
+		cb.block()->mark(UNSEEN);
+	}
+	for (const auto& cb : *compiled_graph) {
+		bool after_voices = false;
+		bool after_after  = false;
+		for (const auto& p : cb.block()->providers()) {
+			if (p->mark() == UNSEEN || p->mark() == AFTER) {
+				after_after = true;
+			} else if (p->mark() == VOICE) {
+				after_voices = true;
+			}
+		}
+
+		Stage stage = BEFORE;
+		if (after_after) {
+			stage = AFTER;
+		} else if (cb.block()->voices_independent()) {
+			stage = VOICE;
+		} else if (after_voices) {
+			stage = AFTER;
+		}
+		cb.block()->mark(stage);
+	}
 
-	output->push_back(CompiledBlock(n));
+	// Split indices into sets, each still in a valid order
+	for (uint32_t i = 0; i < compiled_graph->size(); ++i) {
+		switch ((*compiled_graph)[i].block()->mark()) {
+		case BEFORE:
+			compiled_graph->_before_voices.push_back(i);
+			break;
+		case VOICE:
+			compiled_graph->_voice_blocks.push_back(i);
+			break;
+		default:
+			compiled_graph->_after_voices.push_back(i);
+			break;
+		}
+	}
+
+	if (compiled_graph->_voice_blocks.empty()) {
+		// Nothing to run per voice, so run the graph as usual
+		compiled_graph->_before_voices.clear();
+		compiled_graph->_after_voices.clear();
+	}
 }
 
 CompiledGraph*
@@ -376,21 +662,14 @@ GraphImpl::compile()
 
 	CompiledGraph* const compiled_graph = new CompiledGraph();
 
-	for (auto& b : _blocks) {
-		b.traversed(false);
+	// Blocks are already kept in a valid order, see reorder()
+	if (_n_holes) {
+		compact_order();
 	}
-
-	for (auto& b : _blocks) {
-		// Either a sink or connected to our output ports:
-		if (!b.traversed() && b.dependants().empty()) {
-			compile_recursive(&b, compiled_graph);
-		}
-	}
-
-	// Traverse any blocks we didn't hit yet
-	for (auto& b : _blocks) {
-		if (!b.traversed()) {
-			compile_recursive(&b, compiled_graph);
+	compiled_graph->reserve(_blocks.size());
+	for (BlockImpl* b : _order) {
+		if (b) {
+			compiled_graph->push_back(CompiledBlock(b));
 		}
 	}
 
@@ -400,6 +679,50 @@ GraphImpl::compile()
 		return NULL;
 	}
 
+	const Configuration& conf = _engine.world()->conf();
+	if (conf.option("level-schedule").get<int32_t>()) {
+		compile_levels(compiled_graph);
+	}
+
+	/* Annotate blocks with dependency information for parallel execution.
+	   Only arcs forward in the order count, a provider later in the order is
+	   part of a feedback loop and would never be finished before its
+	   dependant, so the dependant simply reads its output from the last run
+	   as in serial execution. */
+	for (uint32_t i = 0; i < compiled_graph->size(); ++i) {
+		CompiledBlock& cb = (*compiled_graph)[i];
+		for (const auto& p : cb.block()->providers()) {
+			if (p->order_index() < i) {
+				++cb._n_providers;
+			}
+		}
+		for (const auto& d : cb.block()->dependants()) {
+			if (d->order_index() > i) {
+				cb._dependants.push_back(d->order_index());
+			}
+		}
+	}
+
+	/* Find control inputs connected to outputs of another type, which may
+	   change value part way through a cycle (see InputPort::next_value_offset) */
+	for (const auto& a : _arcs) {
+		SPtr<ArcImpl> arc = dynamic_ptr_cast<ArcImpl>(a.second);
+		if (arc &&
+		    arc->head()->type() == PortType::CONTROL &&
+		    arc->tail()->type() != PortType::CONTROL &&
+		    arc->head()->parent_block() != this) {
+			CompiledBlock::Ports& ports =
+				(*compiled_graph)[arc->head()->parent_block()->order_index()]._value_ports;
+			if (std::find(ports.begin(), ports.end(), arc->head()) == ports.end()) {
+				ports.push_back(arc->head());
+			}
+		}
+	}
+	if (conf.option("voice-parallel").get<int32_t>()) {
+		compile_voices(compiled_graph);
+	}
+	compiled_graph->prepare();
+
 	return compiled_graph;
 }
 
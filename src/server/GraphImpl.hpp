@@ -18,6 +18,7 @@
 #define INGEN_ENGINE_GRAPHIMPL_HPP
 
 #include <cstdlib>
+#include <vector>
 
 #include "BlockImpl.hpp"
 #include "CompiledGraph.hpp"
@@ -71,6 +72,15 @@ public:
 	void process(ProcessContext& context);
 	void run(ProcessContext& context);
 
+	/** Process the graph as a block in its parent.
+	 *
+	 * Graphs are never split at value changes, their blocks do that, so the
+	 * compiled value ports are not needed here.
+	 */
+	void process(ProcessContext& context, const CompiledBlock&) {
+		process(context);
+	}
+
 	void set_buffer_size(Context&       context,
 	                     BufferFactory& bufs,
 	                     LV2_URID       type,
@@ -112,6 +122,14 @@ public:
 	 */
 	void remove_block(BlockImpl& block);
 
+	/** Update the execution order after an arc from `tail` to `head` is added.
+	 *
+	 * The order is maintained incrementally, so this only visits blocks
+	 * between `head` and `tail` in the current order which are connected to
+	 * them.  Pre-process thread only.
+	 */
+	void reorder(BlockImpl* tail, BlockImpl* head);
+
 	Blocks&       blocks()       { return _blocks; }
 	const Blocks& blocks() const { return _blocks; }
 
@@ -189,6 +207,36 @@ public:
 	Engine& engine() { return _engine; }
 
 private:
+	/** Sort a compiled graph into levels for level-parallel execution. */
+	void compile_levels(CompiledGraph* compiled_graph);
+
+	typedef std::vector<BlockImpl*> Order;
+
+	/** Collect blocks reachable from `block` within the region being reordered.
+	 *
+	 * Searches dependants with an order index less than `bound` if `forward`,
+	 * otherwise providers with an order index greater than `bound`.
+	 *
+	 * @return false iff `forward` and `stop` was reached (a cycle).
+	 */
+	bool order_search(BlockImpl*       block,
+	                  uint32_t         bound,
+	                  bool             forward,
+	                  const BlockImpl* stop,
+	                  Order&           found);
+
+	/** Remove holes left in the execution order by removed blocks. */
+	void compact_order();
+
+	/** Find blocks in a compiled graph which can be run one voice at a time. */
+	void compile_voices(CompiledGraph* compiled_graph);
+
+	/** Run the compiled graph with the help of process slaves. */
+	void run_parallel(ProcessContext& context);
+
+	/** Run voices of the compiled graph with the help of process slaves. */
+	void run_voices(ProcessContext& context);
+
 	Engine&        _engine;
 	uint32_t       _poly_pre;        ///< Pre-process thread only
 	uint32_t       _poly_process;    ///< Process thread only
@@ -196,6 +244,8 @@ private:
 	Ports          _inputs;          ///< Pre-process thread only
 	Ports          _outputs;         ///< Pre-process thread only
 	Blocks         _blocks;          ///< Pre-process thread only
+	Order          _order;           ///< Execution order, pre-process thread only
+	uint32_t       _n_holes;         ///< Removed blocks in _order
 	bool           _process;
 };
 
@@ -143,24 +143,27 @@ InputPort::max_tail_poly(Context& context) const
 void
 InputPort::pre_process(Context& context)
 {
+	const uint32_t first = context.first_voice();
+	const uint32_t end   = context.end_voice(_poly);
+
 	if (_set_by_user) {
 		// Value has been set (e.g. events pushed) by the user, don't smash it
-		for (uint32_t v = 0; v < _poly; ++v) {
+		for (uint32_t v = first; v < end; ++v) {
 			buffer(v)->update_value_buffer(context.offset());
 		}
 	} else if (_arcs.empty()) {
 		// No incoming arcs, just update set state
-		for (uint32_t v = 0; v < _poly; ++v) {
+		for (uint32_t v = first; v < end; ++v) {
 			update_set_state(context, v);
 		}
 	} else if (direct_connect()) {
 		// Directly connected, use source's buffer directly
-		for (uint32_t v = 0; v < _poly; ++v) {
+		for (uint32_t v = first; v < end; ++v) {
 			_voices->at(v).buffer = _arcs.front().buffer(v);
 		}
 	} else {
 		// Mix down to local buffers in pre_run()
-		for (uint32_t v = 0; v < _poly; ++v) {
+		for (uint32_t v = first; v < end; ++v) {
 			buffer(v)->prepare_write(context);
 		}
 	}
@@ -172,8 +175,9 @@ InputPort::pre_run(Context& context)
 	if (!_set_by_user && !_arcs.empty() && !direct_connect()) {
 		const uint32_t src_poly   = max_tail_poly(context);
 		const uint32_t max_n_srcs = _arcs.size() * src_poly;
+		const uint32_t end        = context.end_voice(_poly);
 
-		for (uint32_t v = 0; v < _poly; ++v) {
+		for (uint32_t v = context.first_voice(); v < end; ++v) {
 			// Get all sources for this voice
 			const Buffer* srcs[max_n_srcs];
 			uint32_t      n_srcs = 0;
@@ -200,12 +204,15 @@ InputPort::pre_run(Context& context)
 }
 
 SampleCount
-InputPort::next_value_offset(SampleCount offset, SampleCount end) const
+InputPort::next_value_offset(const Context& context,
+                             SampleCount    offset,
+                             SampleCount    end) const
 {
 	SampleCount earliest = end;
 	for (const auto& arc : _arcs) {
 		if (arc.tail()->type() != this->type()) {
-			const SampleCount o = arc.tail()->next_value_offset(offset, end);
+			const SampleCount o = arc.tail()->next_value_offset(
+				context, offset, end);
 			if (o < earliest) {
 				earliest = o;
 			}
@@ -222,7 +229,7 @@ InputPort::update_values(SampleCount offset, uint32_t voice)
 void
 InputPort::post_process(Context& context)
 {
-	if (!_arcs.empty() || _force_monitor_update) {
+	if (context.shared() && (!_arcs.empty() || _force_monitor_update)) {
 		monitor(context, _force_monitor_update);
 		_force_monitor_update = false;
 	}
@@ -230,11 +237,16 @@ InputPort::post_process(Context& context)
 	if (_set_by_user) {
 		if (_buffer_type == _bufs.uris().atom_Sequence) {
 			// Clear events received via a SetPortValue
-			for (uint32_t v = 0; v < _poly; ++v) {
+			for (uint32_t v = context.first_voice();
+			     v < context.end_voice(_poly);
+			     ++v) {
 				buffer(v)->prepare_write(context);
 			}
 		}
-		_set_by_user = false;
+		if (context.shared()) {
+			// Only reset once every voice has seen the value
+			_set_by_user = false;
+		}
 	}
 }
 
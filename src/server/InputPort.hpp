@@ -105,7 +105,9 @@ public:
 	/** Prepare buffer for next process cycle. */
 	void post_process(Context& context);
 
-	SampleCount next_value_offset(SampleCount offset, SampleCount end) const;
+	SampleCount next_value_offset(const Context& context,
+	                              SampleCount    offset,
+	                              SampleCount    end) const;
 	void        update_values(SampleCount offset, uint32_t voice);
 
 	size_t num_arcs() const { return _num_arcs; } ///< Pre-process thread
@@ -16,6 +16,7 @@
 
 #include "ingen_config.h"
 
+#include <chrono>
 #include <cstdlib>
 #include <string>
 
@@ -55,6 +56,7 @@ namespace Server {
 
 JackDriver::JackDriver(Engine& engine)
 	: _engine(engine)
+	, _stats(engine)
 	, _sem(0)
 	, _flag(false)
 	, _client(NULL)
@@ -136,6 +138,7 @@ JackDriver::attach(const std::string& server_name,
 
 	jack_set_thread_init_callback(_client, thread_init_cb, this);
 	jack_set_buffer_size_callback(_client, block_length_cb, this);
+	jack_set_xrun_callback(_client, xrun_cb, this);
 #ifdef INGEN_JACK_SESSION
 	jack_set_session_callback(_client, session_cb, this);
 #endif
@@ -473,6 +476,10 @@ JackDriver::_process_cb(jack_nframes_t nframes)
 		return 0;
 	}
 
+	typedef std::chrono::steady_clock Clock;
+
+	const Clock::time_point start = Clock::now();
+
 	/* Note that Jack may not call this function for a cycle, if overloaded,
 	   so a rolling counter here would not always be correct. */
 	const jack_nframes_t start_of_current_cycle = jack_last_frame_time(_client);
@@ -498,6 +505,19 @@ JackDriver::_process_cb(jack_nframes_t nframes)
 		_old_frame += nframes;
 	}
 
+	// Record how long this cycle took, and where the time went
+	CycleStats::Cycle cycle;
+	cycle.time    = start_of_current_cycle;
+	cycle.total   = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		Clock::now() - start).count();
+	cycle.events  = _engine.events_time();
+	cycle.graph   = _engine.graph_time();
+	const BlockImpl* const slowest =
+		_engine.take_slowest_block(cycle.slowest_time);
+	cycle.slowest    = slowest;
+	cycle.slowest_id = slowest ? slowest->id() : 0;
+	_stats.record(cycle, nframes);
+
 	return 0;
 }
 
@@ -516,6 +536,13 @@ JackDriver::_shutdown_cb()
 	_client = NULL;
 }
 
+int
+JackDriver::_xrun_cb()
+{
+	_stats.xrun();
+	return 0;
+}
+
 int
 JackDriver::_block_length_cb(jack_nframes_t nframes)
 {
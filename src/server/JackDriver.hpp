@@ -32,6 +32,7 @@
 
 #include "lv2/lv2plug.in/ns/ext/atom/forge.h"
 
+#include "CycleStats.hpp"
 #include "Driver.hpp"
 #include "EnginePort.hpp"
 
@@ -94,6 +95,12 @@ public:
 
 	inline SampleCount frame_time() const { return _client ? jack_frame_time(_client) : 0; }
 
+	int real_time_priority() const {
+		return _client ? jack_client_real_time_priority(_client) : -1;
+	}
+
+	CycleStats* cycle_stats() { return &_stats; }
+
 	class PortRegistrationFailedException : public std::exception {};
 
 private:
@@ -112,6 +119,9 @@ private:
 	inline static int block_length_cb(jack_nframes_t nframes, void* const jack_driver) {
 		return ((JackDriver*)jack_driver)->_block_length_cb(nframes);
 	}
+	inline static int xrun_cb(void* const jack_driver) {
+		return ((JackDriver*)jack_driver)->_xrun_cb();
+	}
 #ifdef INGEN_JACK_SESSION
 	inline static void session_cb(jack_session_event_t* event, void* jack_driver) {
 		((JackDriver*)jack_driver)->_session_cb(event);
@@ -130,6 +140,7 @@ private:
 	void _shutdown_cb();
 	int  _process_cb(jack_nframes_t nframes);
 	int  _block_length_cb(jack_nframes_t nframes);
+	int  _xrun_cb();
 #ifdef INGEN_JACK_SESSION
 	void _session_cb(jack_session_event_t* event);
 #endif
@@ -139,6 +150,7 @@ protected:
 
 	Engine&                _engine;
 	Ports                  _ports;
+	CycleStats             _stats;
 	LV2_Atom_Forge         _forge;
 	Raul::Semaphore        _sem;
 	std::atomic<bool>      _flag;
@@ -522,10 +522,32 @@ LV2Block::work(uint32_t size, const void* data)
 	}
 }
 
+bool
+LV2Block::voices_independent() const
+{
+	if (!_polyphonic) {
+		return false;
+	}
+
+	/* Each voice is a separate plugin instance, which LV2 allows to run
+	   concurrently, so voices only interfere if they share a port buffer.
+	   Ports of every type are created with a buffer per voice, but check in
+	   case a port has not been given its voices yet.  Work requests from
+	   several voices are serialised by the Worker. */
+	for (uint32_t i = 0; _ports && i < _ports->size(); ++i) {
+		if (_ports->at(i)->poly() != _polyphony) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
 void
 LV2Block::run(ProcessContext& context)
 {
-	for (uint32_t i = 0; i < _polyphony; ++i)
+	const uint32_t end = context.end_voice(_polyphony);
+	for (uint32_t i = context.first_voice(); i < end; ++i)
 		lilv_instance_run(instance(i), context.nframes());
 }
 
@@ -534,7 +556,7 @@ LV2Block::post_process(ProcessContext& context)
 {
 	BlockImpl::post_process(context);
 
-	if (_worker_iface) {
+	if (_worker_iface && context.shared()) {
 		LV2_Handle inst = lilv_instance_get_handle(instance(0));
 		while (!_responses.empty()) {
 			Response& r = _responses.front();
@@ -57,6 +57,8 @@ public:
 	bool prepare_poly(BufferFactory& bufs, uint32_t poly);
 	bool apply_poly(ProcessContext& context, Raul::Maid& maid, uint32_t poly);
 
+	bool voices_independent() const;
+
 	void activate(BufferFactory& bufs);
 	void deactivate();
 
@@ -61,15 +61,22 @@ OutputPort::get_buffers(BufferFactory&      bufs,
 void
 OutputPort::pre_process(Context& context)
 {
-	for (uint32_t v = 0; v < _poly; ++v)
+	const uint32_t end = context.end_voice(_poly);
+	for (uint32_t v = context.first_voice(); v < end; ++v)
 		_voices->at(v).buffer->prepare_output_write(context);
 }
 
 SampleCount
-OutputPort::next_value_offset(SampleCount offset, SampleCount end) const
+OutputPort::next_value_offset(const Context& context,
+                              SampleCount    offset,
+                              SampleCount    end) const
 {
+	// A mono output feeds every voice, otherwise only check voices being run
+	const uint32_t first = (_poly == 1) ? 0 : context.first_voice();
+	const uint32_t last  = (_poly == 1) ? 1 : context.end_voice(_poly);
+
 	SampleCount earliest = end;
-	for (uint32_t v = 0; v < _poly; ++v) {
+	for (uint32_t v = first; v < last; ++v) {
 		const SampleCount o = _voices->at(v).buffer->next_value_offset(offset, end);
 		if (o < earliest) {
 			earliest = o;
@@ -87,12 +94,15 @@ OutputPort::update_values(SampleCount offset, uint32_t voice)
 void
 OutputPort::post_process(Context& context)
 {
-	for (uint32_t v = 0; v < _poly; ++v) {
+	const uint32_t end = context.end_voice(_poly);
+	for (uint32_t v = context.first_voice(); v < end; ++v) {
 		update_set_state(context, v);
 		update_values(0, v);
 	}
 
-	monitor(context);
+	if (context.shared()) {
+		monitor(context);
+	}
 }
 
 } // namespace Server
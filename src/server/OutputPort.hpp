@@ -54,7 +54,9 @@ public:
 	void pre_process(Context& context);
 	void post_process(Context& context);
 
-	SampleCount next_value_offset(SampleCount offset, SampleCount end) const;
+	SampleCount next_value_offset(const Context& context,
+	                              SampleCount    offset,
+	                              SampleCount    end) const;
 	void        update_values(SampleCount offset, uint32_t voice);
 
 	bool is_input()  const { return false; }
@@ -76,6 +76,7 @@ PortImpl::PortImpl(BufferFactory&      bufs,
 	, _is_sample_rate(false)
 	, _is_toggled(false)
 	, _is_driver_port(false)
+	, _is_sample_accurate(false)
 {
 	assert(block != NULL);
 	assert(_poly > 0);
@@ -376,6 +377,13 @@ PortImpl::connect_buffers(SampleCount offset)
 		PortImpl::parent_block()->set_port_buffer(v, _index, buffer(v), offset);
 }
 
+void
+PortImpl::connect_buffers(const Context& context, SampleCount offset)
+{
+	for (uint32_t v = context.first_voice(); v < context.end_voice(_poly); ++v)
+		PortImpl::parent_block()->set_port_buffer(v, _index, buffer(v), offset);
+}
+
 void
 PortImpl::recycle_buffers()
 {
@@ -502,7 +510,9 @@ PortImpl::value_buffer(uint32_t voice)
 }
 
 SampleCount
-PortImpl::next_value_offset(SampleCount offset, SampleCount end) const
+PortImpl::next_value_offset(const Context& context,
+                            SampleCount    offset,
+                            SampleCount    end) const
 {
 	return end;
 }
@@ -17,6 +17,7 @@
 #ifndef INGEN_ENGINE_PORTIMPL_HPP
 #define INGEN_ENGINE_PORTIMPL_HPP
 
+#include <atomic>
 #include <cstdlib>
 
 #include "ingen/Atom.hpp"
@@ -184,6 +185,10 @@ public:
 	                               Resource::Properties& add) {}
 
 	virtual void connect_buffers(SampleCount offset=0);
+
+	/** Connect buffers of the voices processed in `context`. */
+	void connect_buffers(const Context& context, SampleCount offset=0);
+
 	virtual void recycle_buffers();
 
 	virtual bool is_input()  const = 0;
@@ -232,8 +237,9 @@ public:
 	BufferRef value_buffer(uint32_t voice);
 
 	/** Return offset of the first value change after `offset`. */
-	virtual SampleCount next_value_offset(SampleCount offset,
-	                                      SampleCount end) const;
+	virtual SampleCount next_value_offset(const Context& context,
+	                                      SampleCount    offset,
+	                                      SampleCount    end) const;
 
 	/** Update value buffer for `voice` to be current as of `offset`. */
 	virtual void update_values(SampleCount offset, uint32_t voice) = 0;
@@ -255,6 +261,14 @@ public:
 	bool is_sample_rate() const { return _is_sample_rate; }
 	bool is_toggled()     const { return _is_toggled; }
 
+	/** Return true iff every value sent to this port must be applied.
+	 *
+	 * Otherwise, a value may be dropped before it is applied if a later value
+	 * has already been received (see ingen:sampleAccurate).
+	 */
+	bool is_sample_accurate() const { return _is_sample_accurate; }
+	void set_sample_accurate(bool s) { _is_sample_accurate = s; }
+
 protected:
 	PortImpl(BufferFactory&      bufs,
 	         BlockImpl*          block,
@@ -289,6 +303,7 @@ protected:
 	bool                _is_sample_rate;
 	bool                _is_toggled;
 	bool                _is_driver_port;
+	std::atomic<bool>   _is_sample_accurate;
 };
 
 } // namespace Server
@@ -16,6 +16,15 @@
 
 #include <assert.h>
 
+#include <mutex>
+
+#include "ingen/Store.hpp"
+#include "ingen/URIs.hpp"
+#include "ingen/World.hpp"
+
+#include "BlockImpl.hpp"
+#include "Broadcaster.hpp"
+#include "Driver.hpp"
 #include "Engine.hpp"
 #include "Event.hpp"
 #include "PostProcessor.hpp"
@@ -40,6 +49,9 @@ PostProcessor::PostProcessor(Engine& engine)
 	, _head(new Sentinel(engine))
 	, _tail(_head.load())
 	, _max_time(0)
+	, _load_start(0)
+	, _profiling(false)
+	, _blocks_generation(0)
 {
 }
 
@@ -70,7 +82,7 @@ PostProcessor::append(ProcessContext& context, Event* first, Event* last)
 bool
 PostProcessor::pending() const
 {
-	return _head.load() || _engine.process_context().pending_notifications();
+	return _head.load() || _engine.pending_notifications();
 }
 
 void
@@ -85,7 +97,8 @@ PostProcessor::process()
 	Event* next = ev->next();
 	if (!next || next->time() >= end_time) {
 		// Process audio thread notifications until end
-		_engine.process_context().emit_notifications(end_time);
+		_engine.emit_notifications(end_time);
+		publish_loads(end_time);
 		return;
 	}
 
@@ -95,7 +108,7 @@ PostProcessor::process()
 		ev = next;
 
 		// Process audio thread notifications up until this event's time
-		_engine.process_context().emit_notifications(ev->time());
+		_engine.emit_notifications(ev->time());
 
 		// Post-process event
 		ev->post_process();
@@ -109,7 +122,61 @@ PostProcessor::process()
 	_head = ev;
 
 	// Process remaining audio thread notifications until end
-	_engine.process_context().emit_notifications(end_time);
+	_engine.emit_notifications(end_time);
+	publish_loads(end_time);
+}
+
+void
+PostProcessor::publish_loads(FrameTime end)
+{
+	static const unsigned LOAD_RATE = 4;  // Updates per second
+
+	if (!_engine.profiling() || !_engine.driver()) {
+		_profiling = false;
+		return;
+	}
+
+	const SampleCount rate = _engine.driver()->sample_rate();
+	if (_profiling && end - _load_start < rate / LOAD_RATE) {
+		return;  // Not time to publish yet
+	}
+
+	// Don't stall the main thread if the pre-processor is editing the graph
+	const SPtr<Store> store = _engine.store();
+	SharedLock        lock(store->mutex(), std::try_to_lock);
+	if (!lock.owns_lock()) {
+		return;
+	}
+
+	/* Take the time accumulated by every block.  When profiling has just been
+	   enabled, this is discarded since the period it was measured in is
+	   unknown, and only starts the first period. */
+	if (store->generation() != _blocks_generation) {
+		// Objects have been added or removed, find every block again
+		_blocks.clear();
+		for (const auto& s : *store.get()) {
+			BlockImpl* const block = dynamic_cast<BlockImpl*>(s.second.get());
+			if (block) {
+				_blocks.push_back(block);
+			}
+		}
+		_blocks_generation = store->generation();
+	}
+
+	const URIs&  uris   = _engine.world()->uris();
+	const double period = (end - _load_start) * 1000000000.0 / rate;
+	for (BlockImpl* const block : _blocks) {
+		const uint64_t run_time = block->take_run_time();
+		if (_profiling && period > 0.0) {
+			_engine.broadcaster()->set_property(
+				block->uri(),
+				uris.ingen_cpuLoad,
+				uris.forge.make(float(run_time / period)));
+		}
+	}
+
+	_load_start = end;
+	_profiling  = true;
 }
 
 } // namespace Server
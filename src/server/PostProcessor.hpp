@@ -18,6 +18,7 @@
 #define INGEN_ENGINE_POSTPROCESSOR_HPP
 
 #include <atomic>
+#include <vector>
 
 #include "ingen/ingen.h"
 
@@ -26,6 +27,7 @@
 namespace Ingen {
 namespace Server {
 
+class BlockImpl;
 class Engine;
 class Event;
 class ProcessContext;
@@ -62,10 +64,17 @@ public:
 	void set_end_time(FrameTime time) { _max_time = time; }
 
 private:
-	Engine&                _engine;
-	std::atomic<Event*>    _head;
-	std::atomic<Event*>    _tail;
-	std::atomic<FrameTime> _max_time;
+	/** Broadcast the load of every block if profiling and it is time to. */
+	void publish_loads(FrameTime end);
+
+	Engine&                 _engine;
+	std::atomic<Event*>     _head;
+	std::atomic<Event*>     _tail;
+	std::atomic<FrameTime>  _max_time;
+	FrameTime               _load_start; ///< Start of current load period
+	bool                    _profiling; ///< True iff load period has started
+	std::vector<BlockImpl*> _blocks; ///< Every block in the store
+	uint64_t                _blocks_generation; ///< Store generation of _blocks
 };
 
 } // namespace Server
@@ -0,0 +1,86 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEN_ENGINE_PREPROCESSCONTEXT_HPP
+#define INGEN_ENGINE_PREPROCESSCONTEXT_HPP
+
+#include <unordered_set>
+
+namespace Ingen {
+namespace Server {
+
+class GraphImpl;
+
+/** Event pre-processing context.
+ *
+ * This holds state shared between events as they are pre-processed, which
+ * is only ever accessed from the pre-processor thread.
+ *
+ * \ingroup engine
+ */
+class PreProcessContext
+{
+public:
+	typedef std::unordered_set<GraphImpl*> DirtyGraphs;
+
+	PreProcessContext() : _bundle_depth(0) {}
+
+	/** Enter an atomic bundle. */
+	void bundle_begin() { ++_bundle_depth; }
+
+	/** Leave an atomic bundle.
+	 * @return True iff this ended the outermost bundle.
+	 */
+	bool bundle_end() {
+		return _bundle_depth > 0 && --_bundle_depth == 0;
+	}
+
+	/** Return true iff an atomic bundle is being pre-processed.
+	 *
+	 * Each client's bundle is enqueued as a whole (see EventWriter), so the
+	 * events pre-processed while this is true all belong to one bundle, and
+	 * other clients never have their compiles deferred.
+	 */
+	bool in_bundle() const { return _bundle_depth > 0; }
+
+	/** Defer compiling `graph` if an atomic bundle is being pre-processed.
+	 *
+	 * Events that modify a graph call this rather than compiling it
+	 * immediately.  Within a bundle, the graph is recorded as dirty and
+	 * compiled once when the bundle ends.
+	 *
+	 * @return True iff compilation has been deferred.
+	 */
+	bool defer_compile(GraphImpl& graph) {
+		if (_bundle_depth > 0) {
+			_dirty_graphs.insert(&graph);
+			return true;
+		}
+		return false;
+	}
+
+	/** Return the graphs modified by the current bundle. */
+	DirtyGraphs& dirty_graphs() { return _dirty_graphs; }
+
+private:
+	DirtyGraphs _dirty_graphs;
+	unsigned    _bundle_depth;
+};
+
+} // namespace Server
+} // namespace Ingen
+
+#endif // INGEN_ENGINE_PREPROCESSCONTEXT_HPP
@@ -14,7 +14,10 @@
   along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <algorithm>
+#include <chrono>
 #include <stdexcept>
+#include <typeinfo>
 
 #include "Event.hpp"
 #include "PostProcessor.hpp"
@@ -27,19 +30,49 @@ using namespace std;
 namespace Ingen {
 namespace Server {
 
-PreProcessor::PreProcessor()
+/** Maximum number of events to look ahead at for starting concurrently. */
+static const size_t MAX_LOOKAHEAD = 64;
+
+PreProcessor::Job::Job(Event* ev)
+	: event(ev)
+	, scope(ev->scope())
+	, concurrent(ev->is_concurrent())
+	, state(State::WAITING)
+{}
+
+PreProcessor::PreProcessor(unsigned n_workers)
 	: _sem(0)
+	, _inbox(NULL)
 	, _head(NULL)
-	, _prepared_back(NULL)
 	, _tail(NULL)
+	, _n_queued(0)
+	, _head_executed(false)
+	, _n_bundles(0)
+	, _bundle_depth(0)
+	, _publish_depth(0)
+	, _costs()
 	, _exit_flag(false)
-	, _thread(&PreProcessor::run, this)
-{}
+{
+	for (unsigned i = 0; i < n_workers; ++i) {
+		_workers.emplace_back(&PreProcessor::work, this);
+	}
+
+	_thread = std::thread(&PreProcessor::run, this);
+}
 
 PreProcessor::~PreProcessor()
 {
-	if (_thread.joinable()) {
+	{
+		std::lock_guard<std::mutex> lock(_work_mutex);
 		_exit_flag = true;
+	}
+
+	_work_cond.notify_all();
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+
+	if (_thread.joinable()) {
 		_sem.post();
 		_thread.join();
 	}
@@ -48,66 +81,330 @@ PreProcessor::~PreProcessor()
 void
 PreProcessor::event(Event* const ev)
 {
-	// TODO: Probably possible to make this lock-free with CAS
 	ThreadManager::assert_not_thread(THREAD_IS_REAL_TIME);
-	std::lock_guard<std::mutex> lock(_mutex);
 
-	assert(!ev->is_prepared());
-	assert(!ev->next());
+	// Reverse the events into stack order, newest first
+	Event* newest = NULL;
+	size_t n      = 0;
+	for (Event* e = ev; e; ++n) {
+		assert(!e->is_prepared());
+		Event* const next = e->next();
+		e->next(newest);
+		newest = e;
+		e      = next;
+	}
 
-	/* Note that tail is only used here, not in process().  The head must be
-	   checked first here, since if it is NULL the tail pointer is junk. */
-	Event* const head = _head.load();
-	if (!head) {
-		_head = ev;
-		_tail = ev;
+	_n_queued += n;
+
+	/* Push on to the inbox stack.  Since the pre-processor always takes the
+	   whole stack at once there is no ABA problem, and since each producer
+	   pushes its events in order, reversing the stack preserves it. */
+	Event* top = _inbox.load();
+	do {
+		ev->next(top);  // Oldest event, now the bottom of the pushed events
+	} while (!_inbox.compare_exchange_weak(top, newest));
+
+	_sem.post();
+}
+
+void
+PreProcessor::publish(Event* const ev)
+{
+	/* The audio thread only removes the tail by resetting it to NULL with
+	   CAS, so if prev is not NULL here, it will not be removed until it is
+	   linked to ev. */
+	Event* const prev = _tail.exchange(ev);
+	if (prev) {
+		prev->next(ev);
 	} else {
-		_tail.load()->next(ev);
-		_tail = ev;
+		_head = ev;
 	}
 
-	if (!_prepared_back.load()) {
-		_prepared_back = ev;
+	// Count whole bundles, so the audio thread knows when one can be executed
+	switch (ev->get_execution()) {
+	case Event::Execution::NORMAL:
+		break;
+	case Event::Execution::BLOCK:
+		++_publish_depth;
+		break;
+	case Event::Execution::UNBLOCK:
+		if (_publish_depth > 0 && --_publish_depth == 0) {
+			++_n_bundles;
+		}
+		break;
 	}
+}
 
-	_sem.post();
+bool
+PreProcessor::detach(Event* const last)
+{
+	/* Reset the head first, since once the tail is NULL publish() may set the
+	   head to a new event at any time. */
+	_head = NULL;
+
+	Event* tail = last;
+	if (_tail.compare_exchange_strong(tail, NULL)) {
+		return true;
+	}
+
+	// An event is being published after last, and will be linked soon
+	_head = last;
+	return false;
+}
+
+PreProcessor::Cost&
+PreProcessor::cost(const Event& ev)
+{
+	/* Open addressing with linear probing, keyed by the type hash, which is
+	   realtime safe to get for polymorphic types.  There are far fewer types
+	   of event than slots, but use the last probed slot if it is full. */
+	const size_t type = typeid(ev).hash_code() | 1;
+	size_t       i    = type % N_COSTS;
+	for (size_t n = 0; n < N_COSTS - 1; ++n) {
+		if (_costs[i].type == type) {
+			break;
+		} else if (!_costs[i].type) {
+			_costs[i].type = type;
+			break;
+		}
+		i = (i + 1) % N_COSTS;
+	}
+
+	return _costs[i];
 }
 
 unsigned
-PreProcessor::process(ProcessContext& context, PostProcessor& dest, size_t limit)
+PreProcessor::process(ProcessContext& context, PostProcessor& dest, uint64_t budget)
 {
+	typedef std::chrono::steady_clock Clock;
+
 	Event* const head        = _head.load();
 	size_t       n_processed = 0;
+	size_t       n_done      = 0;
+	uint64_t     spent       = 0;  // Time spent executing events in ns
 	Event*       ev          = head;
-	Event*       last        = ev;
-	while (ev && ev->is_prepared() && ev->time() < context.end()) {
+	Event*       prev        = NULL;
+	Event*       last        = NULL;
+	unsigned     depth       = 0;  // Atomic bundle nesting depth
+	if (ev && _head_executed) {
+		// Executed last cycle, but could not be detached from the queue
+		last = ev;
+		ev   = ev->next();
+		++n_done;
+	}
+
+	while (ev) {
+		if (depth == 0) {
+			if (ev->time() >= context.end()) {
+				break;
+			} else if (ev->get_execution() == Event::Execution::BLOCK &&
+			           !_n_bundles.load()) {
+				break;  // Wait until the whole bundle can be executed at once
+			} else if (budget && n_processed > 0 &&
+			           spent + cost(*ev).ns > budget) {
+				break;  // Not expected to fit, leave it for the next cycle
+			}
+		}
+
 		if (ev->time() < context.start()) {
 			// Didn't get around to executing in time, oh well...
 			ev->set_time(context.start());
+		} else if (ev->time() >= context.end()) {
+			// Later event in an atomic bundle, execute it in this cycle
+			ev->set_time(context.end() - 1);
 		}
-		ev->execute(context);
+
+		switch (ev->get_execution()) {
+		case Event::Execution::NORMAL:
+			break;
+		case Event::Execution::BLOCK:
+			if (depth++ == 0) {
+				--_n_bundles;  // Executing a whole published bundle
+			}
+			break;
+		case Event::Execution::UNBLOCK:
+			if (depth > 0) {
+				--depth;
+			}
+			break;
+		}
+
+		/* Execute event, and occasionally update the estimated cost of this
+		   type of event, since reading the clock may cost as much as a cheap
+		   event itself.  Untimed events are assumed to cost the estimate. */
+		Cost& c = cost(*ev);
+		if (c.n_executed++ % TIMING_INTERVAL == 0) {
+			const Clock::time_point start = Clock::now();
+			ev->execute(context);
+			const uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				Clock::now() - start).count();
+
+			c.ns   = c.n_executed > 1 ? (c.ns * 7 + ns) / 8 : ns;
+			spent += ns;
+		} else {
+			ev->execute(context);
+			spent += c.ns;
+		}
+
+		prev = last;
 		last = ev;
 		ev   = ev->next();
 		++n_processed;
-		if (limit && n_processed >= limit) {
-			break;
+		++n_done;
+	}
+
+	if (!last) {
+		return 0;
+	}
+
+	Event* const next = last->next();
+	if (next) {
+		_head          = next;
+		_head_executed = false;
+	} else if (detach(last)) {
+		_head_executed = false;
+	} else {
+		/* Last is the tail but something is being published after it, so it
+		   must stay in the queue until linked.  Keep it as the (already
+		   executed) head, and pass everything before it on. */
+		_head_executed = true;
+		if (!prev) {
+			return n_processed;
 		}
+		last = prev;
+		--n_done;
 	}
 
-	if (n_processed > 0) {
-		Event* next = (Event*)last->next();
-		last->next(NULL);
-		dest.append(context, head, last);
+	last->next(NULL);
+	dest.append(context, head, last);
+	_n_queued -= n_done;
+
+	return n_processed;
+}
+
+/** Return true iff events with scopes `a` and `b` may affect each other. */
+static bool
+conflicts(const Raul::Path& a, const Raul::Path& b)
+{
+	return a == b || a.is_child_of(b) || b.is_child_of(a);
+}
+
+Event*
+PreProcessor::coalesce(Event* const head)
+{
+	Event* first = head;
+	Event* prev  = NULL;
+	for (Event* ev = head; ev;) {
+		Event* const next = ev->next();
 
-		// Since _head was not NULL, we know it hasn't been changed since
-		_head = next;
+		// Events in atomic bundles are never dropped, all are applied together
+		switch (ev->get_execution()) {
+		case Event::Execution::NORMAL:
+			break;
+		case Event::Execution::BLOCK:
+			++_bundle_depth;
+			break;
+		case Event::Execution::UNBLOCK:
+			if (_bundle_depth > 0) {
+				--_bundle_depth;
+			}
+			break;
+		}
 
-		/* If next is NULL, then _tail may now be invalid.  However, it would cause
-		   a race to reset _tail here.  Instead, append() checks only _head for
-		   emptiness, and resets the tail appropriately. */
+		// Look for a later event that supersedes this one
+		bool superseded = false;
+		if (_bundle_depth == 0 && ev->can_be_superseded()) {
+			const Raul::Path scope = ev->scope();
+			size_t           n     = 0;
+			for (const Event* e = next; e && n < MAX_LOOKAHEAD; e = e->next()) {
+				if (ev->is_superseded_by(*e)) {
+					superseded = true;
+					break;
+				} else if (e->get_execution() != Event::Execution::NORMAL ||
+				           conflicts(e->scope(), scope)) {
+					break;
+				}
+				++n;
+			}
+		}
+
+		if (superseded && !ev->wants_response()) {
+			// Nobody is waiting for this event, drop it entirely
+			if (prev) {
+				prev->next(next);
+			} else {
+				first = next;
+			}
+			delete ev;
+			--_n_queued;
+			ev = next;
+			continue;
+		} else if (superseded) {
+			ev->supersede();
+		}
+
+		prev = ev;
+		ev   = next;
 	}
 
-	return n_processed;
+	return first;
+}
+
+void
+PreProcessor::schedule()
+{
+	bool progress = true;
+	while (progress) {
+		progress = false;
+
+		// Publish prepared events at the front, in the order they arrived
+		while (!_jobs.empty() && _jobs.front().state == Job::State::DONE) {
+			publish(_jobs.front().event);
+			_jobs.pop_front();
+		}
+
+		/* Start jobs which do not conflict with any earlier unfinished job.
+		   Events that are not concurrent are pre-processed here, in order,
+		   so they must also wait for every earlier job to be started.  The
+		   first such event is run after starting any later concurrent jobs,
+		   so they are prepared in the meantime. */
+		const size_t n_jobs      = std::min(_jobs.size(), MAX_LOOKAHEAD);
+		Job*         local_job   = NULL;
+		bool         all_started = true;
+		for (size_t i = 0; i < n_jobs; ++i) {
+			Job& job = _jobs[i];
+			if (job.state != Job::State::WAITING) {
+				continue;
+			}
+
+			bool blocked = !job.concurrent && !all_started;
+			for (size_t j = 0; j < i && !blocked; ++j) {
+				blocked = (_jobs[j].state != Job::State::DONE &&
+				           conflicts(_jobs[j].scope, job.scope));
+			}
+
+			if (blocked || !job.concurrent) {
+				all_started = false;
+				if (!blocked) {
+					local_job = &job;
+				}
+			} else {
+				job.state = Job::State::RUNNING;
+				{
+					std::lock_guard<std::mutex> lock(_work_mutex);
+					_work.push_back(&job);
+				}
+				_work_cond.notify_one();
+			}
+		}
+
+		if (local_job) {
+			local_job->state = Job::State::RUNNING;
+			local_job->event->pre_process();
+			local_job->state = Job::State::DONE;
+			progress         = true;
+		}
+	}
 }
 
 void
@@ -115,16 +412,68 @@ PreProcessor::run()
 {
 	ThreadManager::set_flag(THREAD_PRE_PROCESS);
 	while (_sem.wait() && !_exit_flag) {
-		Event* const ev = _prepared_back.load();
-		if (!ev) {
-			return;
+		// Take every enqueued event and reverse them into arrival order
+		Event* ev = NULL;
+		for (Event* e = _inbox.exchange(NULL); e;) {
+			Event* const next = e->next();
+			e->next(ev);
+			ev = e;
+			e  = next;
+		}
+
+		// Drop or skip events made redundant by later ones
+		ev = coalesce(ev);
+
+		if (_workers.empty()) {
+			// Prepare each event and pass it on to the audio thread
+			while (ev) {
+				Event* const next = ev->next();
+				ev->next(NULL);
+
+				assert(!ev->is_prepared());
+				ev->pre_process();
+				assert(ev->is_prepared());
+
+				publish(ev);
+				ev = next;
+			}
+		} else {
+			// Schedule events to be prepared by this thread or workers
+			while (ev) {
+				Event* const next = ev->next();
+				ev->next(NULL);
+				_jobs.emplace_back(ev);
+				ev = next;
+			}
+
+			schedule();
 		}
+	}
+}
 
-		assert(!ev->is_prepared());
-		ev->pre_process();
-		assert(ev->is_prepared());
+void
+PreProcessor::work()
+{
+	ThreadManager::set_flag(THREAD_PRE_PROCESS);
+	while (true) {
+		Job* job = NULL;
+		{
+			std::unique_lock<std::mutex> lock(_work_mutex);
+			while (!_exit_flag && _work.empty()) {
+				_work_cond.wait(lock);
+			}
+
+			if (_exit_flag) {
+				return;
+			}
+
+			job = _work.front();
+			_work.pop_front();
+		}
 
-		_prepared_back = (Event*)ev->next();
+		job->event->pre_process();
+		job->state = Job::State::DONE;
+		_sem.post();  // Wake the pre-processor to publish it
 	}
 }
 
@@ -17,10 +17,16 @@
 #ifndef INGEN_ENGINE_PREPROCESSOR_HPP
 #define INGEN_ENGINE_PREPROCESSOR_HPP
 
+#include <stdint.h>
+
 #include <atomic>
-#include <thread>
+#include <condition_variable>
+#include <deque>
 #include <mutex>
+#include <thread>
+#include <vector>
 
+#include "raul/Path.hpp"
 #include "raul/Semaphore.hpp"
 
 namespace Ingen {
@@ -30,39 +36,124 @@ class Event;
 class PostProcessor;
 class ProcessContext;
 
+/** Queue of events waiting to be pre-processed and executed.
+ *
+ * Any number of threads may enqueue events without locking.  Events are
+ * pushed on to a lock-free stack, which the pre-processor thread takes in
+ * one go, restoring their order.  Each event is then pre-processed and
+ * appended to a queue which the audio thread executes from.
+ *
+ * Events that support it (see Event::is_concurrent()) may be pre-processed
+ * by a pool of worker threads, concurrently with earlier events that do not
+ * affect the same objects.  Events are always passed on to the audio thread
+ * in the order they were enqueued.
+ *
+ * \ingroup engine
+ */
 class PreProcessor
 {
 public:
-	explicit PreProcessor();
+	/** Create a pre-processor.
+	 * @param n_workers Number of worker threads for concurrent events.
+	 */
+	explicit PreProcessor(unsigned n_workers = 0);
 
 	~PreProcessor();
 
 	/** Return true iff no events are enqueued. */
-	inline bool empty() const { return !_head.load(); }
+	inline bool empty() const { return !_n_queued.load(); }
 
 	/** Enqueue an event.
-	 * This is safe to call from any non-realtime thread (it locks).
+	 *
+	 * `ev` may be the first of several events linked with Event::next(),
+	 * which are enqueued together so no other events come between them.
+	 * This is safe to call from any non-realtime thread, and lock-free.
 	 */
 	void event(Event* ev);
 
 	/** Process events for a cycle.
+	 *
+	 * The execution time of each type of event is sampled, and events are
+	 * only executed while they are expected to fit in `budget`.  At least one
+	 * event is always executed, so expensive events still make progress.
+	 *
+	 * Atomic bundles are never split: a bundle is only executed once all of
+	 * its events have been prepared, and then entirely within this cycle,
+	 * regardless of `budget` or the time stamps of its events.
+	 *
+	 * @param budget Time to spend executing events in ns, or zero for no limit.
 	 * @return The number of events processed.
 	 */
 	unsigned process(ProcessContext& context,
 	                 PostProcessor&  dest,
-	                 size_t          limit = 0);
+	                 uint64_t        budget = 0);
 
 protected:
 	void run();
 
+	void work();
+
 private:
-	std::mutex          _mutex;
-	Raul::Semaphore     _sem;
-	std::atomic<Event*> _head;
-	std::atomic<Event*> _prepared_back;
-	std::atomic<Event*> _tail;
-	bool                _exit_flag;
-	std::thread         _thread;
+	/** Estimated execution time of a type of event (audio thread only). */
+	struct Cost {
+		size_t   type;        ///< Hash code of event type, or 0 if unused
+		uint64_t ns;          ///< Moving average of execution time
+		uint32_t n_executed;  ///< Number of events of this type executed
+	};
+
+	static const size_t   N_COSTS         = 64;
+	static const uint32_t TIMING_INTERVAL = 16;  ///< Time every nth event
+
+	/** Return the execution cost estimate for the type of `ev`. */
+	Cost& cost(const Event& ev);
+
+	/** An event being scheduled for pre-processing (pre-processor only). */
+	struct Job {
+		enum class State { WAITING, RUNNING, DONE };
+
+		explicit Job(Event* ev);
+
+		Event* const       event;
+		const Raul::Path   scope;
+		const bool         concurrent;
+		std::atomic<State> state;
+	};
+
+	/** Drop or mark events superseded by later ones in the list `head`.
+	 * @return The new head of the list.
+	 */
+	Event* coalesce(Event* head);
+
+	/** Start every job that can be, and publish finished ones in order. */
+	void schedule();
+
+	/** Append a prepared event for the audio thread (pre-processor only). */
+	void publish(Event* ev);
+
+	/** Remove the tail `last` from the queue if possible (audio thread only).
+	 * @return False if an event is being published after `last`.
+	 */
+	bool detach(Event* last);
+
+	Raul::Semaphore       _sem;
+	std::atomic<Event*>   _inbox;          ///< Newly enqueued events, newest first
+	std::atomic<Event*>   _head;           ///< Next prepared event to execute
+	std::atomic<Event*>   _tail;           ///< Last prepared event
+	std::atomic<size_t>   _n_queued;       ///< Events enqueued but not executed
+	bool                  _head_executed;  ///< Head executed but not detached
+	std::atomic<unsigned> _n_bundles;      ///< Whole bundles published, not executed
+	unsigned              _bundle_depth;   ///< Bundle depth of events taken
+	unsigned              _publish_depth;  ///< Bundle depth of events published
+	std::deque<Job>       _jobs;           ///< Events being pre-processed
+	Cost                  _costs[N_COSTS]; ///< Hash table of execution costs
+
+	std::mutex               _work_mutex;
+	std::condition_variable  _work_cond;
+	std::deque<Job*>         _work;     ///< Jobs waiting for a worker
+	std::vector<std::thread> _workers;
+
+	bool        _exit_flag;
+	std::thread _thread;
 };
 
 } // namespace Server
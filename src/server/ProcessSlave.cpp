@@ -0,0 +1,105 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <pthread.h>
+
+#include "ingen/Log.hpp"
+
+#include "CompiledGraph.hpp"
+#include "Engine.hpp"
+#include "ProcessSlave.hpp"
+#include "ThreadManager.hpp"
+#include "util.hpp"
+
+namespace Ingen {
+namespace Server {
+
+ProcessSlave::ProcessSlave(Engine& engine, unsigned id, int priority)
+	: _engine(engine)
+	, _id(id)
+	, _context(engine)
+	, _sem(0)
+	, _graph(NULL)
+	, _state(State::IDLE)
+	, _exit_flag(false)
+	, _thread(&ProcessSlave::run, this)
+{
+	if (priority > 0) {
+		sched_param sp;
+		sp.sched_priority = priority;
+		if (pthread_setschedparam(_thread.native_handle(), SCHED_FIFO, &sp)) {
+			engine.log().warn(
+				fmt("Failed to set real-time priority of process slave %1%\n")
+				% id);
+		}
+	}
+}
+
+ProcessSlave::~ProcessSlave()
+{
+	_exit_flag = true;
+	_sem.post();
+	_thread.join();
+}
+
+bool
+ProcessSlave::whip(CompiledGraph* graph, const ProcessContext& context)
+{
+	/* Claim the slave before setting up its run, so it does not start working
+	   early if woken by a post left over from a cancelled run. */
+	State idle = State::IDLE;
+	if (!_state.compare_exchange_strong(idle, State::CLAIMED)) {
+		return false;  // Busy helping some other thread
+	}
+
+	_context.locate(context);
+	_context.slice(context.offset(), context.nframes());
+	_graph = graph;
+	_state = State::WHIPPED;
+	_sem.post();
+	return true;
+}
+
+void
+ProcessSlave::finish()
+{
+	/* If the slave has not woken up yet, cancel its run since all the work is
+	   done already.  Otherwise, wait for it to notice that and return. */
+	State whipped = State::WHIPPED;
+	if (!_state.compare_exchange_strong(whipped, State::IDLE)) {
+		while (_state.load() != State::IDLE) {}
+	}
+}
+
+void
+ProcessSlave::run()
+{
+	ThreadManager::set_flag(THREAD_PROCESS);
+	ThreadManager::set_flag(THREAD_IS_REAL_TIME);
+	set_denormal_flags(_engine.log());
+
+	while (_sem.wait() && !_exit_flag) {
+		State whipped = State::WHIPPED;
+		if (_state.compare_exchange_strong(whipped, State::WORKING)) {
+			_graph->work(_context);
+			_state = State::IDLE;
+		}
+		// Otherwise, run was cancelled by finish() before we woke up
+	}
+}
+
+} // namespace Server
+} // namespace Ingen
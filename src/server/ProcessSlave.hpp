@@ -0,0 +1,89 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEN_ENGINE_PROCESSSLAVE_HPP
+#define INGEN_ENGINE_PROCESSSLAVE_HPP
+
+#include <atomic>
+#include <thread>
+
+#include "raul/Noncopyable.hpp"
+#include "raul/Semaphore.hpp"
+
+#include "ProcessContext.hpp"
+
+namespace Ingen {
+namespace Server {
+
+class CompiledGraph;
+class Engine;
+
+/** A thread which helps the process thread execute a graph in parallel.
+ *
+ * The process thread "whips" slaves at the start of a parallel graph run,
+ * after which every thread (including the process thread itself) executes
+ * blocks as soon as all of their providers have finished.  Each slave has its
+ * own ProcessContext, so blocks running in a slave send notifications through
+ * a separate ring.
+ *
+ * \ingroup engine
+ */
+class ProcessSlave : public Raul::Noncopyable
+{
+public:
+	ProcessSlave(Engine& engine, unsigned id, int priority);
+	~ProcessSlave();
+
+	/** Start working on `graph` if this slave is idle (process threads only).
+	 *
+	 * Several process threads may try to whip the same slave, for example
+	 * when polyphonic subgraphs run their voices in parallel, but only one
+	 * will succeed.
+	 *
+	 * @return true iff the slave was whipped, in which case the caller must
+	 * call finish() when the work is done.
+	 */
+	bool whip(CompiledGraph* graph, const ProcessContext& context);
+
+	/** Wait until this slave has stopped working.
+	 *
+	 * This must only be called by the thread that whipped the slave, once all
+	 * the work has been claimed, so it will never wait for long.
+	 */
+	void finish();
+
+	unsigned        id()      const { return _id; }
+	ProcessContext& context()       { return _context; }
+
+private:
+	enum class State { IDLE, CLAIMED, WHIPPED, WORKING };
+
+	void run();
+
+	Engine&            _engine;
+	unsigned           _id;
+	ProcessContext     _context;
+	Raul::Semaphore    _sem;
+	CompiledGraph*     _graph;
+	std::atomic<State> _state;
+	std::atomic<bool>  _exit_flag;
+	std::thread        _thread;
+};
+
+} // namespace Server
+} // namespace Ingen
+
+#endif // INGEN_ENGINE_PROCESSSLAVE_HPP
@@ -0,0 +1,718 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "ingen/Log.hpp"
+#include "ingen/URIs.hpp"
+#include "ingen/World.hpp"
+#include "lv2/lv2plug.in/ns/ext/atom/util.h"
+
+#include "Buffer.hpp"
+#include "DuplexPort.hpp"
+#include "Engine.hpp"
+#include "PostProcessor.hpp"
+#include "RenderDriver.hpp"
+
+namespace Ingen {
+namespace Server {
+
+/** A MIDI event at a frame time relative to the start of rendering. */
+struct MidiEvent {
+	FrameTime            time;
+	std::vector<uint8_t> data;
+};
+
+typedef std::vector<MidiEvent> MidiEvents;
+
+class RenderDriver::RenderPort : public EnginePort {
+public:
+	explicit RenderPort(DuplexPort* graph_port)
+		: EnginePort(graph_port)
+		, next_event(0)
+		, file(NULL)
+		, n_written(0)
+	{}
+
+	std::vector<float> block;       ///< Driver buffer for audio and CV
+	std::vector<float> samples;     ///< Input audio
+	MidiEvents         events;      ///< Input or output MIDI
+	size_t             next_event;  ///< Index of next input event
+	FILE*              file;        ///< Output audio file
+	uint64_t           n_written;   ///< Frames written to output audio file
+};
+
+static inline uint16_t
+read_le16(const uint8_t* p)
+{
+	return p[0] | (p[1] << 8);
+}
+
+static inline uint32_t
+read_le32(const uint8_t* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t
+read_be32(const uint8_t* p)
+{
+	return ((uint32_t)p[0] << 24) | (p[1] << 16) | (p[2] << 8) | p[3];
+}
+
+static inline void
+write_le16(FILE* file, uint16_t v)
+{
+	const uint8_t buf[] = { uint8_t(v), uint8_t(v >> 8) };
+	fwrite(buf, 1, sizeof(buf), file);
+}
+
+static inline void
+write_le32(FILE* file, uint32_t v)
+{
+	const uint8_t buf[] = { uint8_t(v), uint8_t(v >> 8),
+	                        uint8_t(v >> 16), uint8_t(v >> 24) };
+	fwrite(buf, 1, sizeof(buf), file);
+}
+
+static inline void
+append_be32(std::vector<uint8_t>& buf, uint32_t v)
+{
+	buf.push_back(v >> 24);
+	buf.push_back(v >> 16);
+	buf.push_back(v >> 8);
+	buf.push_back(v);
+}
+
+/** Append a MIDI file variable length quantity. */
+static void
+append_vlq(std::vector<uint8_t>& buf, uint32_t v)
+{
+	uint8_t bytes[5];
+	unsigned n = 0;
+	do {
+		bytes[n++] = v & 0x7F;
+		v >>= 7;
+	} while (v);
+
+	while (n > 1) {
+		buf.push_back(bytes[--n] | 0x80);
+	}
+	buf.push_back(bytes[0]);
+}
+
+/** Read a MIDI file variable length quantity, or return false at `end`. */
+static bool
+read_vlq(const uint8_t*& p, const uint8_t* end, uint32_t& v)
+{
+	v = 0;
+	for (unsigned i = 0; i < 4 && p < end; ++i) {
+		const uint8_t c = *p++;
+		v = (v << 7) | (c & 0x7F);
+		if (!(c & 0x80)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+static bool
+read_file(const std::string& path, std::vector<uint8_t>& data)
+{
+	FILE* file = fopen(path.c_str(), "rb");
+	if (!file) {
+		return false;
+	}
+
+	uint8_t buf[4096];
+	for (size_t n; (n = fread(buf, 1, sizeof(buf), file)) > 0;) {
+		data.insert(data.end(), buf, buf + n);
+	}
+
+	fclose(file);
+	return true;
+}
+
+/** Read the first channel of a PCM or floating point WAV file. */
+static bool
+read_wav(Log&                log,
+         const std::string&  path,
+         const uint8_t*      data,
+         size_t              size,
+         SampleCount         rate,
+         std::vector<float>& samples)
+{
+	if (size < 12 || memcmp(data, "RIFF", 4) || memcmp(data + 8, "WAVE", 4)) {
+		log.error(fmt("%1% is not a WAV file\n") % path);
+		return false;
+	}
+
+	uint16_t       format    = 0;
+	uint16_t       channels  = 0;
+	uint32_t       file_rate = 0;
+	uint16_t       bits      = 0;
+	const uint8_t* pcm       = NULL;
+	uint32_t       pcm_size  = 0;
+	for (size_t offset = 12; offset + 8 <= size;) {
+		const uint8_t* body = data + offset + 8;
+		const uint32_t len  = std::min(size_t(read_le32(data + offset + 4)),
+		                               size - offset - 8);
+		if (!memcmp(data + offset, "fmt ", 4) && len >= 16) {
+			format    = read_le16(body);
+			channels  = read_le16(body + 2);
+			file_rate = read_le32(body + 4);
+			bits      = read_le16(body + 14);
+			if (format == 0xFFFE && len >= 26) {
+				format = read_le16(body + 24);  // WAVE_FORMAT_EXTENSIBLE
+			}
+		} else if (!memcmp(data + offset, "data", 4)) {
+			pcm      = body;
+			pcm_size = len;
+		}
+		offset += 8 + len + (len & 1);
+	}
+
+	const bool is_float = (format == 3 && (bits == 32 || bits == 64));
+	const bool is_int   = (format == 1 && bits >= 8 && bits <= 32 && !(bits % 8));
+	if (!pcm || !channels || (!is_float && !is_int)) {
+		log.error(fmt("Unsupported WAV format in %1%\n") % path);
+		return false;
+	} else if (file_rate != rate) {
+		log.warn(fmt("%1% has sample rate %2%, not %3%\n")
+		         % path % file_rate % rate);
+	}
+	if (channels > 1) {
+		log.warn(fmt("Only using first channel of %1%\n") % path);
+	}
+
+	const uint32_t bytes      = bits / 8;
+	const uint32_t frame_size = bytes * channels;
+	const uint32_t n_frames   = pcm_size / frame_size;
+	samples.resize(n_frames);
+	for (uint32_t i = 0; i < n_frames; ++i) {
+		const uint8_t* const p = pcm + i * frame_size;
+		if (format == 3 && bits == 32) {
+			float f;
+			memcpy(&f, p, sizeof(f));
+			samples[i] = f;
+		} else if (format == 3) {
+			double d;
+			memcpy(&d, p, sizeof(d));
+			samples[i] = d;
+		} else if (bits == 8) {
+			samples[i] = (p[0] - 128) / 128.0f;
+		} else {
+			// Shift the sample to the top of an int32 to sign extend it
+			uint32_t v = 0;
+			for (uint32_t b = 0; b < bytes; ++b) {
+				v |= (uint32_t)p[b] << (8 * (4 - bytes + b));
+			}
+			samples[i] = int32_t(v) / 2147483648.0f;
+		}
+	}
+
+	return true;
+}
+
+/** Read every event of a standard MIDI file, sorted by time. */
+static bool
+read_midi(Log&               log,
+          const std::string& path,
+          const uint8_t*     data,
+          size_t             size,
+          SampleCount        rate,
+          MidiEvents&        events)
+{
+	if (size < 14 || memcmp(data, "MThd", 4) || read_be32(data + 4) < 6) {
+		log.error(fmt("%1% is not a MIDI file\n") % path);
+		return false;
+	}
+
+	const uint16_t n_tracks = (data[10] << 8) | data[11];
+	const uint16_t division = (data[12] << 8) | data[13];
+
+	struct TickEvent {
+		uint64_t             tick;
+		std::vector<uint8_t> data;
+	};
+	struct Tempo {
+		uint64_t tick;
+		uint32_t usec_per_quarter;
+	};
+
+	std::vector<TickEvent> tick_events;
+	std::vector<Tempo>     tempos;
+
+	const uint8_t* p = data + 8 + read_be32(data + 4);
+	for (uint16_t t = 0; t < n_tracks && p + 8 <= data + size; ++t) {
+		const uint32_t       len   = read_be32(p + 4);
+		const uint8_t* const end   = std::min(p + 8 + len, data + size);
+		const bool           track = !memcmp(p, "MTrk", 4);
+		uint64_t             tick  = 0;
+		uint8_t              status = 0;
+		for (p += 8; track && p < end;) {
+			uint32_t delta = 0;
+			if (!read_vlq(p, end, delta) || p >= end) {
+				break;
+			}
+			tick += delta;
+
+			if (*p & 0x80) {
+				status = *p++;
+			} else if (!status) {
+				log.error(fmt("Bad running status in %1%\n") % path);
+				return false;
+			}
+
+			uint32_t ev_len = 0;
+			if (status == 0xFF) {  // Meta event
+				if (p >= end) {
+					break;
+				}
+				const uint8_t type = *p++;
+				if (!read_vlq(p, end, ev_len) || p + ev_len > end) {
+					break;
+				} else if (type == 0x51 && ev_len == 3) {
+					tempos.push_back(
+						Tempo{tick, uint32_t((p[0] << 16) | (p[1] << 8) | p[2])});
+				}
+				p += ev_len;
+				status = 0;
+				continue;
+			} else if (status == 0xF0 || status == 0xF7) {  // System exclusive
+				if (!read_vlq(p, end, ev_len) || p + ev_len > end) {
+					break;
+				}
+				TickEvent ev{tick, std::vector<uint8_t>()};
+				if (status == 0xF0) {
+					ev.data.push_back(0xF0);
+				}
+				ev.data.insert(ev.data.end(), p, p + ev_len);
+				tick_events.push_back(ev);
+				p += ev_len;
+				status = 0;
+				continue;
+			}
+
+			const uint8_t type = status & 0xF0;
+			ev_len = (type == 0xC0 || type == 0xD0) ? 1 : 2;
+			if (p + ev_len > end) {
+				break;
+			}
+			TickEvent ev{tick, std::vector<uint8_t>(1, status)};
+			ev.data.insert(ev.data.end(), p, p + ev_len);
+			tick_events.push_back(ev);
+			p += ev_len;
+		}
+		p = end;
+	}
+
+	// Sort by time, keeping events at the same time in file order
+	std::stable_sort(tick_events.begin(), tick_events.end(),
+	                 [](const TickEvent& a, const TickEvent& b) {
+		                 return a.tick < b.tick;
+	                 });
+	std::stable_sort(tempos.begin(), tempos.end(),
+	                 [](const Tempo& a, const Tempo& b) {
+		                 return a.tick < b.tick;
+	                 });
+
+	// Convert ticks to frames using the tempo map
+	double   seconds_per_tick = 0.5 / division;  // Default 120 BPM
+	double   segment_start    = 0.0;
+	uint64_t segment_tick     = 0;
+	size_t   next_tempo       = 0;
+	if (division & 0x8000) {
+		// SMPTE frames per second and ticks per frame, tempo is irrelevant
+		const int fps = -int8_t(division >> 8);
+		seconds_per_tick = 1.0 / (fps * (division & 0xFF));
+		next_tempo       = tempos.size();
+	}
+
+	for (const TickEvent& ev : tick_events) {
+		while (next_tempo < tempos.size() && tempos[next_tempo].tick <= ev.tick) {
+			const Tempo& tempo = tempos[next_tempo++];
+			segment_start += (tempo.tick - segment_tick) * seconds_per_tick;
+			segment_tick     = tempo.tick;
+			seconds_per_tick = tempo.usec_per_quarter / (division * 1000000.0);
+		}
+
+		const double seconds = segment_start
+			+ (ev.tick - segment_tick) * seconds_per_tick;
+		events.push_back(MidiEvent{FrameTime(seconds * rate + 0.5), ev.data});
+	}
+
+	return true;
+}
+
+/** Write events to a type 0 standard MIDI file at 120 BPM. */
+static bool
+write_midi(const std::string& path, SampleCount rate, const MidiEvents& events)
+{
+	static const uint32_t division = 960;
+
+	std::vector<uint8_t> track;
+	append_vlq(track, 0);
+	const uint8_t tempo[] = { 0xFF, 0x51, 0x03, 0x07, 0xA1, 0x20 };
+	track.insert(track.end(), tempo, tempo + sizeof(tempo));
+
+	uint64_t last_tick = 0;
+	for (const MidiEvent& ev : events) {
+		const uint64_t tick = ev.time * division * 2 / rate;
+		append_vlq(track, tick - last_tick);
+		if (ev.data[0] == 0xF0) {
+			track.push_back(0xF0);
+			append_vlq(track, ev.data.size() - 1);
+			track.insert(track.end(), ev.data.begin() + 1, ev.data.end());
+		} else {
+			track.insert(track.end(), ev.data.begin(), ev.data.end());
+		}
+		last_tick = tick;
+	}
+	const uint8_t end_of_track[] = { 0x00, 0xFF, 0x2F, 0x00 };
+	track.insert(track.end(), end_of_track, end_of_track + sizeof(end_of_track));
+
+	std::vector<uint8_t> header = { 'M', 'T', 'h', 'd', 0, 0, 0, 6,
+	                                0, 0, 0, 1, division >> 8, division & 0xFF,
+	                                'M', 'T', 'r', 'k' };
+	append_be32(header, track.size());
+
+	FILE* file = fopen(path.c_str(), "wb");
+	if (!file) {
+		return false;
+	}
+	const bool success = (
+		fwrite(header.data(), 1, header.size(), file) == header.size() &&
+		fwrite(track.data(), 1, track.size(), file) == track.size());
+	return !fclose(file) && success;
+}
+
+/** Write a mono floating point WAV header for `n_frames` frames. */
+static void
+write_wav_header(FILE* file, SampleCount rate, uint64_t n_frames)
+{
+	const uint32_t data_size = n_frames * sizeof(float);
+
+	fwrite("RIFF", 1, 4, file);
+	write_le32(file, 36 + data_size);
+	fwrite("WAVEfmt ", 1, 8, file);
+	write_le32(file, 16);
+	write_le16(file, 3);  // IEEE float
+	write_le16(file, 1);  // Channels
+	write_le32(file, rate);
+	write_le32(file, rate * sizeof(float));
+	write_le16(file, sizeof(float));
+	write_le16(file, 32);
+	fwrite("data", 1, 4, file);
+	write_le32(file, data_size);
+}
+
+RenderDriver::RenderDriver(Engine&            engine,
+                           const std::string& input_dir,
+                           const std::string& output_dir,
+                           SampleCount        sample_rate,
+                           SampleCount        block_length,
+                           size_t             seq_size)
+	: _engine(engine)
+	, _input_dir(input_dir)
+	, _output_dir(output_dir)
+	, _sample_rate(sample_rate)
+	, _block_length(block_length)
+	, _seq_size(seq_size)
+	, _frame_time(0)
+	, _position(0)
+	, _rendering(false)
+{}
+
+struct PortDisposer {
+	void operator()(EnginePort* port) { delete port; }
+};
+
+RenderDriver::~RenderDriver()
+{
+	for (auto& p : _ports) {
+		finish_port(static_cast<RenderPort*>(&p));
+	}
+	_ports.clear_and_dispose(PortDisposer());
+}
+
+EnginePort*
+RenderDriver::create_port(DuplexPort* graph_port)
+{
+	RenderPort* port = NULL;
+	if (graph_port->is_a(PortType::AUDIO) || graph_port->is_a(PortType::CV)) {
+		port = new RenderPort(graph_port);
+		port->block.resize(_block_length);
+		graph_port->set_is_driver_port(*_engine.buffer_factory());
+	} else if (graph_port->is_a(PortType::ATOM) &&
+	           graph_port->buffer_type() == _engine.world()->uris().atom_Sequence) {
+		port = new RenderPort(graph_port);
+	}
+
+	if (port) {
+		register_port(*port);
+	}
+
+	return port;
+}
+
+EnginePort*
+RenderDriver::get_port(const Raul::Path& path)
+{
+	for (auto& p : _ports) {
+		if (p.graph_port()->path() == path) {
+			return &p;
+		}
+	}
+
+	return NULL;
+}
+
+void
+RenderDriver::add_port(ProcessContext& context, EnginePort* port)
+{
+	_ports.push_back(*port);
+}
+
+void
+RenderDriver::remove_port(ProcessContext& context, EnginePort* port)
+{
+	_ports.erase(_ports.iterator_to(*port));
+}
+
+void
+RenderDriver::register_port(EnginePort& eport)
+{
+	RenderPort* const  port       = static_cast<RenderPort*>(&eport);
+	DuplexPort* const  graph_port = port->graph_port();
+	const bool         is_audio   = !port->block.empty();
+	const std::string& symbol     = graph_port->symbol();
+	Log&               log        = _engine.log();
+
+	if (graph_port->is_input() && !_input_dir.empty()) {
+		// Read entire input file into memory
+		const std::string    base = _input_dir + "/" + symbol;
+		std::vector<uint8_t> data;
+		if (is_audio && read_file(base + ".wav", data)) {
+			read_wav(log, base + ".wav", data.data(), data.size(),
+			         _sample_rate, port->samples);
+		} else if (is_audio && read_file(base + ".raw", data)) {
+			port->samples.resize(data.size() / sizeof(float));
+			memcpy(port->samples.data(), data.data(),
+			       port->samples.size() * sizeof(float));
+		} else if (!is_audio && read_file(base + ".mid", data)) {
+			read_midi(log, base + ".mid", data.data(), data.size(),
+			          _sample_rate, port->events);
+		}
+	} else if (graph_port->is_output() && is_audio) {
+		// Open output file and write a header to be updated when finished
+		const std::string path = _output_dir + "/" + symbol + ".wav";
+		if ((port->file = fopen(path.c_str(), "wb"))) {
+			write_wav_header(port->file, _sample_rate, 0);
+		} else {
+			log.error(fmt("Failed to open %1% (%2%)\n") % path % strerror(errno));
+		}
+	}
+}
+
+void
+RenderDriver::unregister_port(EnginePort& port)
+{
+	finish_port(static_cast<RenderPort*>(&port));
+}
+
+void
+RenderDriver::finish_port(RenderPort* port)
+{
+	if (port->file) {
+		// Rewrite header with the final size
+		fseek(port->file, 0, SEEK_SET);
+		write_wav_header(port->file, _sample_rate, port->n_written);
+		fclose(port->file);
+		port->file = NULL;
+	} else if (port->graph_port()->is_output() && !port->events.empty()) {
+		const std::string path =
+			_output_dir + "/" + port->graph_port()->symbol() + ".mid";
+		if (!write_midi(path, _sample_rate, port->events)) {
+			_engine.log().error(fmt("Failed to write %1%\n") % path);
+		}
+		port->events.clear();
+	}
+}
+
+void
+RenderDriver::pre_process_port(ProcessContext& context, RenderPort* port)
+{
+	const URIs&       uris       = context.engine().world()->uris();
+	const SampleCount nframes    = context.nframes();
+	DuplexPort*       graph_port = port->graph_port();
+
+	if (graph_port->is_a(PortType::AUDIO) || graph_port->is_a(PortType::CV)) {
+		float* const buf = port->block.data();
+		if (graph_port->is_input()) {
+			// Copy samples for this cycle from input file, if there are any
+			const size_t n_samples = port->samples.size();
+			const size_t begin     = std::min(size_t(_position), n_samples);
+			const size_t n_read    = _rendering
+				? std::min(size_t(nframes), n_samples - begin) : 0;
+			std::copy(port->samples.begin() + begin,
+			          port->samples.begin() + begin + n_read,
+			          buf);
+			std::fill(buf + n_read, buf + nframes, 0.0f);
+		}
+
+		graph_port->set_driver_buffer(buf, nframes * sizeof(float));
+		if (graph_port->is_input()) {
+			graph_port->monitor(context);
+		} else {
+			graph_port->buffer(0)->clear();
+		}
+	} else if (graph_port->buffer_type() == uris.atom_Sequence) {
+		Buffer* const graph_buf = graph_port->buffer(0).get();
+		graph_buf->prepare_write(context);
+		if (graph_port->is_input() && _rendering) {
+			// Copy events for this cycle from input file into graph port buffer
+			const MidiEvents& events = port->events;
+			for (; port->next_event < events.size() &&
+				     events[port->next_event].time < _position + nframes;
+			     ++port->next_event) {
+				const MidiEvent& ev = events[port->next_event];
+				if (!graph_buf->append_event(ev.time - _position,
+				                             ev.data.size(),
+				                             uris.midi_MidiEvent,
+				                             ev.data.data())) {
+					_engine.log().warn("Failed to write to MIDI buffer, events lost!\n");
+				}
+			}
+		}
+		graph_port->monitor(context);
+	}
+}
+
+void
+RenderDriver::post_process_port(ProcessContext& context, RenderPort* port)
+{
+	const URIs&       uris       = context.engine().world()->uris();
+	const SampleCount nframes    = context.nframes();
+	DuplexPort*       graph_port = port->graph_port();
+
+	if (graph_port->is_output() && _rendering) {
+		if (port->file) {
+			port->n_written += fwrite(
+				port->block.data(), sizeof(float), nframes, port->file);
+		} else if (graph_port->buffer_type() == uris.atom_Sequence) {
+			// Record MIDI events to write to a file when finished
+			Buffer* const      graph_buf = graph_port->buffer(0).get();
+			LV2_Atom_Sequence* seq       = graph_buf->get<LV2_Atom_Sequence>();
+			LV2_ATOM_SEQUENCE_FOREACH(seq, ev) {
+				const uint8_t* buf = (const uint8_t*)LV2_ATOM_BODY(&ev->body);
+				if (ev->body.type == uris.midi_MidiEvent && ev->body.size > 0) {
+					port->events.push_back(
+						MidiEvent{_position + ev->time.frames,
+						          std::vector<uint8_t>(buf, buf + ev->body.size)});
+				}
+			}
+		}
+	}
+
+	// Reset graph port buffer pointer to no longer point to our buffer
+	if (graph_port->is_driver_port()) {
+		graph_port->set_driver_buffer(NULL, 0);
+	}
+}
+
+unsigned
+RenderDriver::run(SampleCount nframes)
+{
+	_engine.process_context().locate(_frame_time, nframes);
+
+	for (auto& p : _ports) {
+		pre_process_port(_engine.process_context(), static_cast<RenderPort*>(&p));
+	}
+
+	const unsigned n_processed = _engine.run(nframes);
+
+	for (auto& p : _ports) {
+		post_process_port(_engine.process_context(), static_cast<RenderPort*>(&p));
+	}
+
+	_frame_time += nframes;
+	return n_processed;
+}
+
+bool
+RenderDriver::render(FrameTime length)
+{
+	// Finish processing any events (like loading a graph) before rolling
+	while (_engine.pending_events() || _engine.post_processor()->pending()) {
+		if (!run(_block_length)) {
+			// Waiting for the pre-processor, don't spin too hard
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		}
+		_engine.main_iteration();
+	}
+
+	if (length == 0) {
+		// Render until the end of the longest input
+		for (const auto& p : _ports) {
+			const RenderPort& port = static_cast<const RenderPort&>(p);
+			length = std::max(length, FrameTime(port.samples.size()));
+			if (!port.events.empty() && port.graph_port()->is_input()) {
+				length = std::max(length, port.events.back().time + 1);
+			}
+		}
+		if (length == 0) {
+			_engine.log().error("Nothing to render (no inputs or length)\n");
+			return false;
+		}
+	}
+
+	typedef std::chrono::steady_clock Clock;
+
+	const Clock::time_point start = Clock::now();
+
+	_rendering = true;
+	for (_position = 0; _position < length;) {
+		const SampleCount nframes = std::min(FrameTime(_block_length),
+		                                     length - _position);
+		run(nframes);
+		_engine.main_iteration();
+		_position += nframes;
+	}
+	_rendering = false;
+
+	for (auto& p : _ports) {
+		finish_port(static_cast<RenderPort*>(&p));
+	}
+
+	const double seconds = std::chrono::duration<double>(
+		Clock::now() - start).count();
+	_engine.log().info(
+		fmt("Rendered %1% frames in %2% seconds (%3% times real time)\n")
+		% length % seconds % (length / (seconds * _sample_rate)));
+
+	return true;
+}
+
+} // namespace Server
+} // namespace Ingen
@@ -0,0 +1,119 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEN_ENGINE_RENDERDRIVER_HPP
+#define INGEN_ENGINE_RENDERDRIVER_HPP
+
+#include <string>
+
+#include <boost/intrusive/list.hpp>
+
+#include "Driver.hpp"
+
+namespace Ingen {
+namespace Server {
+
+class Engine;
+
+/** Driver for rendering graphs offline, as fast as possible.
+ *
+ * Root graph inputs are read from files in an input directory named after the
+ * port symbol: audio and CV ports from `symbol.wav` (or raw native floats in
+ * `symbol.raw`), and sequence ports from a standard MIDI file `symbol.mid`.
+ * Inputs without a file are silent.  Outputs are written to a floating point
+ * `symbol.wav` or a MIDI file `symbol.mid` in the output directory.
+ *
+ * Rendering happens in the thread that calls render(), which is not real-time,
+ * so port files are simply read and written while processing.  If the engine
+ * has process slaves, they run graphs in parallel as usual.
+ *
+ * \ingroup engine
+ */
+class RenderDriver : public Driver {
+public:
+	RenderDriver(Engine&            engine,
+	             const std::string& input_dir,
+	             const std::string& output_dir,
+	             SampleCount        sample_rate,
+	             SampleCount        block_length,
+	             size_t             seq_size);
+
+	~RenderDriver();
+
+	/** Render the current graph.
+	 *
+	 * This first processes any pending events (e.g. loading a graph), then
+	 * runs the engine for `length` frames, or the length of the longest input
+	 * if `length` is zero.
+	 *
+	 * @return true on success, false if there was nothing to render.
+	 */
+	bool render(FrameTime length);
+
+	EnginePort* create_port(DuplexPort* graph_port);
+	EnginePort* get_port(const Raul::Path& path);
+
+	void add_port(ProcessContext& context, EnginePort* port);
+	void remove_port(ProcessContext& context, EnginePort* port);
+	void register_port(EnginePort& port);
+	void unregister_port(EnginePort& port);
+
+	void rename_port(const Raul::Path& old_path,
+	                 const Raul::Path& new_path) {}
+
+	void port_property(const Raul::Path& path,
+	                   const Raul::URI&  uri,
+	                   const Atom&       value) {}
+
+	SampleCount block_length() const { return _block_length; }
+	size_t      seq_size()     const { return _seq_size; }
+	SampleCount sample_rate()  const { return _sample_rate; }
+	SampleCount frame_time()   const { return _frame_time; }
+
+	void append_time_events(ProcessContext& context, Buffer& buffer) {}
+
+private:
+	class RenderPort;
+
+	/** Run a single cycle of `nframes` frames.
+	 * @return the number of events processed.
+	 */
+	unsigned run(SampleCount nframes);
+
+	void pre_process_port(ProcessContext& context, RenderPort* port);
+	void post_process_port(ProcessContext& context, RenderPort* port);
+
+	/** Finish writing any output file for `port`. */
+	void finish_port(RenderPort* port);
+
+	typedef boost::intrusive::list<EnginePort> Ports;
+
+	Engine&           _engine;
+	Ports             _ports;
+	const std::string _input_dir;
+	const std::string _output_dir;
+	SampleCount       _sample_rate;
+	SampleCount       _block_length;
+	size_t            _seq_size;
+	SampleCount       _frame_time;  ///< Frames run in total
+	FrameTime         _position;    ///< Position in files while rendering
+	bool              _rendering;   ///< True iff files are being read/written
+};
+
+} // namespace Server
+} // namespace Ingen
+
+#endif // INGEN_ENGINE_RENDERDRIVER_HPP
@@ -15,16 +15,24 @@
 */
 
 #include <errno.h>
-#include <poll.h>
 #include <signal.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <chrono>
+#include <map>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <vector>
 
+#include "ingen/AtomStream.hpp"
 #include "ingen/Configuration.hpp"
+#include "ingen/Log.hpp"
 #include "ingen/Module.hpp"
 #include "ingen/World.hpp"
 #include "raul/Socket.hpp"
@@ -119,49 +127,141 @@ SocketListener::ingen_listen(Engine*       engine,
 		return;  // No sockets to listen to, exit thread
 	}
 
-	struct pollfd pfds[2];
-	int           nfds = 0;
-	if (unix_sock->fd() != -1) {
-		pfds[nfds].fd      = unix_sock->fd();
-		pfds[nfds].events  = POLLIN;
-		pfds[nfds].revents = 0;
-		++nfds;
+	const int epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_fd == -1) {
+		world->log().error(fmt("Failed to create epoll instance (%1%)\n")
+		                   % strerror(errno));
+		return;
 	}
-	if (net_sock->fd() != -1) {
-		pfds[nfds].fd      = net_sock->fd();
-		pfds[nfds].events  = POLLIN;
-		pfds[nfds].revents = 0;
-		++nfds;
+
+	for (Raul::Socket* sock : { unix_sock, net_sock }) {
+		if (sock->fd() != -1) {
+			struct epoll_event ev;
+			ev.events  = EPOLLIN;
+			ev.data.fd = sock->fd();
+			epoll_ctl(epoll_fd, EPOLL_CTL_ADD, sock->fd(), &ev);
+		}
 	}
 
-	while (true) {
-		// Wait for input to arrive at a socket
-		const int ret = poll(pfds, nfds, -1);
-		if (ret == -1) {
-			world->log().error(fmt("Poll error: %1%\n") % strerror(errno));
-			break;
-		} else if (ret == 0) {
-			world->log().warn("Poll returned with no data\n");
+	typedef std::chrono::steady_clock Clock;
+
+	// A connection waiting for the client to choose a format
+	struct Pending {
+		SPtr<Raul::Socket> sock;
+		Clock::time_point  deadline;
+	};
+
+	std::map<int, Pending>       pending;  // Connections by fd
+	std::map<int, SocketServer*> servers;  // Connections by fd
+
+	// Start serving a pending connection in the chosen format
+	auto serve = [&](int fd, AtomStream::Format format) {
+		SPtr<Raul::Socket> conn = pending[fd].sock;
+		pending.erase(fd);
+		epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+		servers[fd] = new SocketServer(*world, *engine, conn, format, epoll_fd);
+	};
+
+	struct epoll_event events[32];
+	bool               done = false;
+	while (!done) {
+		// Wait until input arrives or the next pending connection times out
+		int timeout = -1;
+		for (const auto& p : pending) {
+			const int ms = std::max(
+				0, (int)std::chrono::duration_cast<std::chrono::milliseconds>(
+					p.second.deadline - Clock::now()).count());
+			timeout = (timeout == -1) ? ms : std::min(timeout, ms);
+		}
+
+		const int n = epoll_wait(epoll_fd, events, 32, timeout);
+		if (n == -1 && errno == EINTR) {
 			continue;
-		} else if ((pfds[0].revents & POLLHUP) || pfds[1].revents & POLLHUP) {
+		} else if (n == -1) {
+			world->log().error(fmt("Poll error: %1%\n") % strerror(errno));
 			break;
 		}
 
-		if (pfds[0].revents & POLLIN) {
-			SPtr<Raul::Socket> conn = unix_sock->accept();
-			if (conn) {
-				new SocketServer(*world, *engine, conn);
+		std::vector<int> closed;
+		for (int i = 0; i < n; ++i) {
+			const int      fd    = events[i].data.fd;
+			const uint32_t flags = events[i].events;
+			if (fd == unix_sock->fd() || fd == net_sock->fd()) {
+				if (flags & (EPOLLERR|EPOLLHUP)) {
+					done = true;  // Listening socket shut down
+					continue;
+				}
+
+				// Accept connection and greet with support for atoms
+				Raul::Socket* const sock = (fd == unix_sock->fd()
+				                            ? unix_sock : net_sock);
+				SPtr<Raul::Socket> conn = sock->accept();
+				if (!conn) {
+					continue;
+				}
+
+				const size_t len = strlen(AtomStream::GREETING);
+				if (send(conn->fd(), AtomStream::GREETING, len,
+				         MSG_DONTWAIT|MSG_NOSIGNAL) != (ssize_t)len) {
+					world->log().error(fmt("Failed to greet client (%1%)\n")
+					                   % strerror(errno));
+					continue;
+				}
+
+				// Wait for the client to choose a format
+				pending[conn->fd()] = Pending{
+					conn, Clock::now() + std::chrono::milliseconds(1000) };
+
+				struct epoll_event ev;
+				ev.events  = EPOLLIN;
+				ev.data.fd = conn->fd();
+				epoll_ctl(epoll_fd, EPOLL_CTL_ADD, conn->fd(), &ev);
+			} else if (pending.count(fd)) {
+				const int match = AtomStream::check_magic(fd, AtomStream::MAGIC);
+				if (match > 0) {
+					serve(fd, AtomStream::Format::ATOM);
+				} else if (match < 0) {
+					serve(fd, AtomStream::Format::TURTLE);  // Or hangup
+				} else if (flags & (EPOLLERR|EPOLLHUP)) {
+					epoll_ctl(epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+					pending.erase(fd);
+				}
+			} else if (servers.count(fd)) {
+				SocketServer* const server = servers[fd];
+				if (((flags & EPOLLIN) && !server->receive()) ||
+				    ((flags & EPOLLOUT) && !server->flush()) ||
+				    (flags & (EPOLLERR|EPOLLHUP))) {
+					closed.push_back(fd);
+				}
 			}
 		}
 
-		if (pfds[1].revents & POLLIN) {
-			SPtr<Raul::Socket> conn = net_sock->accept();
-			if (conn) {
-				new SocketServer(*world, *engine, conn);
+		// Destroy closed connections
+		for (int fd : closed) {
+			delete servers[fd];
+			servers.erase(fd);
+		}
+
+		// Fall back to Turtle for clients that have said nothing
+		const Clock::time_point now = Clock::now();
+		for (auto p = pending.begin(); p != pending.end();) {
+			const int  fd      = p->first;
+			const bool expired = p->second.deadline <= now;
+			++p;
+			if (expired) {
+				serve(fd, AtomStream::Format::TURTLE);
 			}
 		}
 	}
 
+	for (auto& s : servers) {
+		delete s.second;
+	}
+	for (auto& p : pending) {
+		epoll_ctl(epoll_fd, EPOLL_CTL_DEL, p.first, NULL);
+	}
+	close(epoll_fd);
+
 	if (make_link) {
 		unlink(link_path.c_str());
 	}
@@ -24,7 +24,11 @@
 namespace Ingen {
 namespace Server {
 
-/** Listens on main sockets and spawns socket servers for new connections. */
+/** Listens on main sockets and serves all connections in a single thread.
+ *
+ * New connections are greeted, given a moment to choose the atom protocol,
+ * then served by a SocketServer.  All socket I/O is driven by one epoll loop.
+ */
 class SocketListener
 {
 public:
@@ -0,0 +1,338 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+
+#include "ingen/Log.hpp"
+#include "ingen/SocketReader.hpp"
+#include "ingen/SocketWriter.hpp"
+#include "ingen/URIs.hpp"
+#include "ingen/World.hpp"
+#include "lv2/lv2plug.in/ns/ext/atom/util.h"
+
+#include "Broadcaster.hpp"
+#include "Engine.hpp"
+#include "SocketServer.hpp"
+
+#ifndef MSG_NOSIGNAL
+#    define MSG_NOSIGNAL 0
+#endif
+
+namespace Ingen {
+namespace Server {
+
+/** Backlog size over which monitor updates are dropped. */
+static const size_t QUEUE_LIMIT = 1 << 20;
+
+/** Backlog size at which a client is disconnected. */
+static const size_t QUEUE_MAX = 1 << 24;
+
+/** A SocketReader for Turtle input that shuts the socket down on hangup.
+ *
+ * This makes the socket hang up in the I/O loop as well, which then destroys
+ * the connection.
+ */
+class SocketServer::Reader : public SocketReader
+{
+public:
+	Reader(World& world, Interface& iface, SPtr<Raul::Socket> sock)
+		: SocketReader(world, iface, sock)
+		, _socket(sock)
+	{}
+
+protected:
+	void on_hangup() { _socket->shutdown(); }
+
+private:
+	SPtr<Raul::Socket> _socket;
+};
+
+/** A SocketWriter that queues messages to be sent by the I/O loop.
+ *
+ * Messages are queued as atoms, and only encoded when the I/O loop flushes
+ * the queue, so sending a message costs the sending thread no more than
+ * queueing it, and broadcasts share a single atom.  While more than
+ * QUEUE_LIMIT bytes are queued, monitor updates are dropped and atom input
+ * is not read.  A client that falls QUEUE_MAX behind is disconnected.  The
+ * writer may outlive its connection, since events hold on to it to respond,
+ * so it only touches the I/O loop while attached.
+ */
+class SocketServer::Writer : public SocketWriter, public BroadcastSink
+{
+public:
+	Writer(World& world, SPtr<Raul::Socket> sock, AtomStream::Format format)
+		: SocketWriter(world.uri_map(), world.uris(), sock->uri(), sock, format)
+		, _world(world)
+		, _head(0)
+		, _backlog(0)
+		, _epoll(-1)
+		, _events(0)
+		, _dropped(0)
+		, _overflow(false)
+	{}
+
+	void attach(int epoll_fd) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_epoll = epoll_fd;
+
+		struct epoll_event ev;
+		ev.events  = _events = interest();
+		ev.data.fd = fd();
+		epoll_ctl(_epoll, EPOLL_CTL_ADD, fd(), &ev);
+	}
+
+	void detach() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		epoll_ctl(_epoll, EPOLL_CTL_DEL, fd(), NULL);
+		_epoll = -1;
+		if (_dropped) {
+			_world.log().warn(fmt("Dropped %1% updates to slow client <%2%>\n")
+			                  % _dropped % _uri);
+		}
+	}
+
+	void broadcast(SPtr<const LV2_Atom> msg, bool monitor) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (monitor && _backlog > QUEUE_LIMIT) {
+			++_dropped;  // Client is behind, drop monitor update
+		} else {
+			enqueue(msg);
+		}
+	}
+
+	bool write(const LV2_Atom* msg) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return enqueue(share_atom(msg));
+	}
+
+	/** Append encoded output, which is only done by the I/O loop. */
+	bool write_bytes(const void* buf, size_t len) {
+		const uint8_t* const bytes = (const uint8_t*)buf;
+		_bytes.insert(_bytes.end(), bytes, bytes + len);
+		return true;
+	}
+
+	bool flush() {
+		while (true) {
+			// Send as much encoded output as possible
+			size_t sent = 0;
+			while (_head < _bytes.size()) {
+				const ssize_t n = send(fd(),
+				                       &_bytes[_head],
+				                       _bytes.size() - _head,
+				                       MSG_DONTWAIT|MSG_NOSIGNAL);
+				if (n < 0 && errno == EINTR) {
+					continue;
+				} else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+					break;
+				} else if (n <= 0) {
+					return false;
+				}
+				_head += n;
+				sent  += n;
+			}
+
+			SPtr<const LV2_Atom> msg;
+			{
+				std::lock_guard<std::mutex> lock(_mutex);
+				_backlog -= sent;
+				if (_head < _bytes.size() || _messages.empty()) {
+					update_events();
+					return true;  // Socket is full, or everything is sent
+				}
+
+				msg = _messages.front();
+				_messages.pop_front();
+				_backlog -= lv2_atom_total_size(msg.get());
+			}
+
+			// Encode the next message, which only this thread touches
+			_bytes.clear();
+			_head = 0;
+			if (msg->type == _uris.forge.Tuple) {
+				// Batch of broadcast messages
+				LV2_ATOM_TUPLE_FOREACH((const LV2_Atom_Tuple*)msg.get(), m) {
+					SocketWriter::write(m);
+				}
+			} else {
+				SocketWriter::write(msg.get());
+			}
+
+			std::lock_guard<std::mutex> lock(_mutex);
+			_backlog += _bytes.size();
+		}
+	}
+
+private:
+	/** Queue a message with the mutex held. */
+	bool enqueue(SPtr<const LV2_Atom> msg) {
+		const uint32_t size = lv2_atom_total_size(msg.get());
+		if (_overflow) {
+			return false;
+		} else if (_backlog + size > QUEUE_MAX) {
+			_world.log().error(
+				fmt("Disconnecting client <%1%> which is too far behind\n")
+				% _uri);
+			_overflow = true;
+			_socket->shutdown();
+			return false;
+		}
+
+		_messages.push_back(msg);
+		_backlog += size;
+		update_events();
+		return true;
+	}
+
+	/** Return the events to poll for, with the mutex held. */
+	uint32_t interest() const {
+		uint32_t events = 0;
+		if (_format == AtomStream::Format::ATOM && _backlog < QUEUE_LIMIT) {
+			events |= EPOLLIN;  // Stop reading requests while far behind
+		}
+		if (_backlog > 0) {
+			events |= EPOLLOUT;
+		}
+		return events;
+	}
+
+	/** Update the events to poll for, with the mutex held. */
+	void update_events() {
+		const uint32_t events = interest();
+		if (_epoll != -1 && events != _events) {
+			struct epoll_event ev;
+			ev.events  = _events = events;
+			ev.data.fd = fd();
+			epoll_ctl(_epoll, EPOLL_CTL_MOD, fd(), &ev);
+		}
+	}
+
+	World&                           _world;
+	std::mutex                       _mutex;
+	std::deque<SPtr<const LV2_Atom>> _messages;  ///< Messages to encode
+	std::vector<uint8_t>             _bytes;     ///< Encoded output
+	size_t                           _head;      ///< Offset of unsent output
+	size_t                           _backlog;   ///< Bytes not sent yet
+	int                              _epoll;     ///< I/O loop, or -1
+	uint32_t                         _events;    ///< Events polled for
+	unsigned                         _dropped;   ///< Dropped updates
+	bool                             _overflow;  ///< Disconnected
+};
+
+SocketServer::SocketServer(World&             world,
+                           Server::Engine&    engine,
+                           SPtr<Raul::Socket> sock,
+                           AtomStream::Format format,
+                           int                epoll_fd)
+	: EventWriter(engine)
+	, _world(world)
+	, _socket(sock)
+	, _writer(new Writer(world, sock, format))
+	, _stream(world.uri_map())
+	, _atom_reader(world.uri_map(),
+	               world.uris(),
+	               world.log(),
+	               world.forge(),
+	               *this)
+{
+	set_respondee(_writer);
+	engine.register_client(_writer);
+	_writer->attach(epoll_fd);
+
+	if (format == AtomStream::Format::TURTLE) {
+		_reader = std::unique_ptr<Reader>(new Reader(world, *this, sock));
+	}
+}
+
+SocketServer::~SocketServer()
+{
+	_writer->detach();
+	_socket->shutdown();
+	_reader.reset();
+	end_bundles();
+	_engine.unregister_client(_writer);
+}
+
+bool
+SocketServer::receive()
+{
+	// Read everything available
+	static const size_t chunk = 65536;
+	while (true) {
+		const size_t  len = _in.size();
+		_in.resize(len + chunk);
+		const ssize_t n   = recv(_socket->fd(), &_in[len], chunk, MSG_DONTWAIT);
+		_in.resize(len + std::max(n, (ssize_t)0));
+		if (n == 0) {
+			return false;  // Hangup
+		} else if (n < 0 && errno == EINTR) {
+			continue;
+		} else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+			break;
+		} else if (n < 0) {
+			return false;
+		}
+	}
+
+	// Handle every complete frame
+	size_t offset = 0;
+	while (_in.size() - offset >= sizeof(LV2_Atom)) {
+		LV2_Atom head;
+		memcpy(&head, &_in[offset], sizeof(head));
+		if (head.size > AtomStream::MAX_FRAME_SIZE) {
+			_world.log().error(fmt("Message too large (%1% bytes)\n")
+			                   % head.size);
+			return false;
+		}
+
+		const uint32_t size = sizeof(LV2_Atom) + lv2_atom_pad_size(head.size);
+		if (_in.size() - offset < size) {
+			break;  // Incomplete, wait for the rest
+		}
+
+		// Copy to an aligned buffer and call methods based on its content
+		_frame.resize(size / sizeof(uint64_t));
+		memcpy(_frame.data(), &_in[offset], size);
+		offset += size;
+
+		LV2_Atom* const frame = (LV2_Atom*)_frame.data();
+		if (_stream.read(frame, size)) {
+			_atom_reader.write(frame);
+		} else if (frame->type) {
+			_world.log().error("Invalid message\n");
+		}
+	}
+
+	_in.erase(_in.begin(), _in.begin() + offset);
+	return true;
+}
+
+bool
+SocketServer::flush()
+{
+	return _writer->flush();
+}
+
+}  // namespace Server
+}  // namespace Ingen
@@ -17,53 +17,71 @@
 #ifndef INGEN_SERVER_SOCKET_SERVER_HPP
 #define INGEN_SERVER_SOCKET_SERVER_HPP
 
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
 #include "raul/Socket.hpp"
 
-#include "ingen/SocketReader.hpp"
-#include "ingen/SocketWriter.hpp"
+#include "ingen/AtomReader.hpp"
+#include "ingen/AtomStream.hpp"
+#include "ingen/types.hpp"
 
 #include "EventWriter.hpp"
 
 namespace Ingen {
+
+class World;
+
 namespace Server {
 
-/** The server side of an Ingen socket connection. */
-class SocketServer : public EventWriter, public SocketReader
+/** The server side of an Ingen socket connection.
+ *
+ * Connections are driven by the I/O loop of the SocketListener, which calls
+ * receive() when input arrives and flush() when queued output may be sent,
+ * so output to a slow client never blocks the threads that send to it.
+ *
+ * Atom input is read in that loop, but Turtle input is read by a SocketReader
+ * thread, since the Turtle parser can not stop in the middle of a message.
+ */
+class SocketServer : public EventWriter
 {
 public:
+	/** Create a connection and add its socket to `epoll_fd`. */
 	SocketServer(World&             world,
 	             Server::Engine&    engine,
-	             SPtr<Raul::Socket> sock)
-		: EventWriter(engine)
-		, SocketReader(world, *this, sock)
-		, _engine(engine)
-		, _writer(new SocketWriter(world.uri_map(),
-		                           world.uris(),
-		                           sock->uri(),
-		                           sock))
-	{
-		set_respondee(_writer);
-		engine.register_client(_writer);
-	}
-
-	~SocketServer() {
-		if (_writer) {
-			_engine.unregister_client(_writer);
-		}
-	}
-
-protected:
-	void on_hangup() {
-		_engine.unregister_client(_writer);
-		_writer.reset();
-	}
+	             SPtr<Raul::Socket> sock,
+	             AtomStream::Format format,
+	             int                epoll_fd);
+
+	~SocketServer();
+
+	/** Read and handle all available input.
+	 * @return False if the client has hung up.
+	 */
+	bool receive();
+
+	/** Send as much queued output as possible.
+	 * @return False if the connection is broken.
+	 */
+	bool flush();
 
 private:
-	Server::Engine&    _engine;
-	SPtr<SocketWriter> _writer;
+	class Reader;
+	class Writer;
+
+	World&                  _world;
+	SPtr<Raul::Socket>      _socket;
+	SPtr<Writer>            _writer;
+	AtomStream              _stream;
+	AtomReader              _atom_reader;
+	std::vector<uint8_t>    _in;     ///< Received atom input
+	std::vector<uint64_t>   _frame;  ///< Aligned frame being read
+	std::unique_ptr<Reader> _reader;  ///< Turtle reader thread
 };
 
+}  // namespace Server
 }  // namespace Ingen
-}  // namespace Socket
 
 #endif  // INGEN_SERVER_SOCKET_SERVER_HPP
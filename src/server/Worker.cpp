@@ -50,6 +50,18 @@ LV2_Worker_Status
 Worker::request(LV2Block*   block,
                 uint32_t    size,
                 const void* data)
+{
+	// Blocks may run in several process threads, so serialise writes
+	while (_request_lock.test_and_set(std::memory_order_acquire)) {}
+	const LV2_Worker_Status st = write_request(block, size, data);
+	_request_lock.clear(std::memory_order_release);
+	return st;
+}
+
+LV2_Worker_Status
+Worker::write_request(LV2Block*   block,
+                      uint32_t    size,
+                      const void* data)
 {
 	Engine& engine = block->parent_graph()->engine();
 	if (_requests.write_space() < sizeof(MessageHeader) + size) {
@@ -108,7 +120,9 @@ Worker::Worker(Log& log, uint32_t buffer_size)
 	, _buffer((uint8_t*)malloc(buffer_size))
 	, _buffer_size(buffer_size)
 	, _thread(&Worker::run, this)
-{}
+{
+	_request_lock.clear();
+}
 
 Worker::~Worker()
 {
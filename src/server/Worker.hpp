@@ -17,6 +17,7 @@
 #ifndef INGEN_ENGINE_WORKER_HPP
 #define INGEN_ENGINE_WORKER_HPP
 
+#include <atomic>
 #include <thread>
 
 #include "ingen/LV2Features.hpp"
@@ -51,6 +52,10 @@ public:
 	SPtr<Schedule> schedule_feature() { return _schedule; }
 
 private:
+	LV2_Worker_Status write_request(LV2Block*   block,
+	                                uint32_t    size,
+	                                const void* data);
+
 	SPtr<Schedule> _schedule;
 
 	Log&             _log;
@@ -59,6 +64,7 @@ private:
 	Raul::RingBuffer _responses;
 	uint8_t* const   _buffer;
 	const uint32_t   _buffer_size;
+	std::atomic_flag _request_lock;
 	bool             _exit_flag;
 	std::thread      _thread;
 
@@ -26,6 +26,7 @@
 #include "events/Disconnect.hpp"
 #include "events/DisconnectAll.hpp"
 #include "events/Get.hpp"
+#include "events/Mark.hpp"
 #include "events/Move.hpp"
 #include "events/Copy.hpp"
 #include "events/SetPortValue.hpp"
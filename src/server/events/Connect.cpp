@@ -50,7 +50,7 @@ Connect::Connect(Engine&           engine,
 bool
 Connect::pre_process()
 {
-	std::unique_lock<std::mutex> lock(_engine.store()->mutex());
+	std::unique_lock<SharedMutex> lock(_engine.store()->mutex());
 
 	Node* tail = _engine.store()->get(_tail_path);
 	if (!tail) {
@@ -113,6 +113,7 @@ Connect::pre_process()
 	if (tail_block != head_block && tail_block->parent() == head_block->parent()) {
 		head_block->providers().insert(tail_block);
 		tail_block->dependants().insert(head_block);
+		_graph->reorder(tail_block, head_block);
 	}
 
 	_graph->add_arc(_arc);
@@ -131,7 +132,7 @@ Connect::pre_process()
 		                   false);
 	}
 
-	if (_graph->enabled()) {
+	if (_graph->enabled() && !_engine.pre_process_context().defer_compile(*_graph)) {
 		_compiled_graph = _graph->compile();
 	}
 
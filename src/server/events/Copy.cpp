@@ -50,7 +50,15 @@ Copy::Copy(Engine&          engine,
 bool
 Copy::pre_process()
 {
-	std::unique_lock<std::mutex> lock(_engine.store()->mutex());
+	// Saving only reads the graph, so may run alongside other readers
+	SharedMutex&                  mutex = _engine.store()->mutex();
+	std::unique_lock<SharedMutex> lock(mutex, std::defer_lock);
+	SharedLock                    read_lock(mutex, std::defer_lock);
+	if (Node::uri_is_path(_old_uri) && _new_uri.scheme() == "file") {
+		read_lock.lock();
+	} else {
+		lock.lock();
+	}
 
 	if (Node::uri_is_path(_old_uri)) {
 		// Old URI is a path within the engine
@@ -125,7 +133,7 @@ Copy::engine_to_engine()
 	_engine.store()->add(_block);
 
 	// Compile graph with new block added for insertion in audio thread
-	if (_parent->enabled()) {
+	if (_parent->enabled() && !_engine.pre_process_context().defer_compile(*_parent)) {
 		_compiled_graph = _parent->compile();
 	}
 
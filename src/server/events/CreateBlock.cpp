@@ -127,17 +127,20 @@ CreateBlock::pre_process()
 	}
 
 	// Activate block
-	_block->properties().insert(_properties.begin(), _properties.end());
+	_block->add_properties(_properties);
 	_block->activate(*_engine.buffer_factory());
 
 	// Add block to the store and the graph's pre-processor only block list
-	_graph->add_block(*_block);
-	store->add(_block);
+	{
+		std::lock_guard<SharedMutex> lock(store->mutex());
+		_graph->add_block(*_block);
+		store->add(_block);
+	}
 
 	/* Compile graph with new block added for insertion in audio thread
 	   TODO: Since the block is not connected at this point, a full compilation
 	   could be avoided and the block simply appended. */
-	if (_graph->enabled()) {
+	if (_graph->enabled() && !_engine.pre_process_context().defer_compile(*_graph)) {
 		_compiled_graph = _graph->compile();
 	}
 
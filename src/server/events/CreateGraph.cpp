@@ -161,17 +161,22 @@ CreateGraph::pre_process()
 		_parent->add_block(*_graph);
 		if (_parent->enabled()) {
 			_graph->enable();
-			_compiled_graph = _parent->compile();
+			if (!_engine.pre_process_context().defer_compile(*_parent)) {
+				_compiled_graph = _parent->compile();
+			}
 		}
 	}
 
 	_graph->activate(*_engine.buffer_factory());
 
 	// Insert into store and build update to send to clients
-	_engine.store()->add(_graph);
-	_update.put_graph(_graph);
-	for (BlockImpl& block : _graph->blocks()) {
-		_engine.store()->add(&block);
+	{
+		std::lock_guard<SharedMutex> lock(_engine.store()->mutex());
+		_engine.store()->add(_graph);
+		_update.put_graph(_graph);
+		for (BlockImpl& block : _graph->blocks()) {
+			_engine.store()->add(&block);
+		}
 	}
 
 	// Build and pre-process child events to create standard ports
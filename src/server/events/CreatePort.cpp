@@ -142,13 +142,22 @@ CreatePort::pre_process()
 	                             _port_type, _buf_type, buf_size,
 	                             value, _flow == Flow::OUTPUT);
 
-	_graph_port->properties().insert(_properties.begin(), _properties.end());
-
-	_engine.store()->add(_graph_port);
-	if (_flow == Flow::OUTPUT) {
-		_graph->add_output(*_graph_port);
-	} else {
-		_graph->add_input(*_graph_port);
+	_graph_port->add_properties(_properties);
+
+	const PropIter accurate_i = _properties.find(uris.ingen_sampleAccurate);
+	_graph_port->set_sample_accurate(
+		accurate_i != _properties.end() &&
+		accurate_i->second.type() == uris.forge.Bool &&
+		accurate_i->second.get<int32_t>());
+
+	{
+		std::lock_guard<SharedMutex> lock(_engine.store()->mutex());
+		_engine.store()->add(_graph_port);
+		if (_flow == Flow::OUTPUT) {
+			_graph->add_output(*_graph_port);
+		} else {
+			_graph->add_input(*_graph_port);
+		}
 	}
 
 	if (!_graph->parent()) {
@@ -84,7 +84,7 @@ Delete::pre_process()
 	}
 
 	// Take a writer lock while we modify the store
-	std::unique_lock<std::mutex> lock(_engine.store()->mutex());
+	std::unique_lock<SharedMutex> lock(_engine.store()->mutex());
 
 	_engine.store()->remove(iter, _removed_objects);
 
@@ -93,7 +93,8 @@ Delete::pre_process()
 		_disconnect_event = new DisconnectAll(_engine, parent, _block.get());
 		_disconnect_event->pre_process();
 
-		if (parent->enabled()) {
+		if (parent->enabled() &&
+		    !_engine.pre_process_context().defer_compile(*parent)) {
 			_compiled_graph = parent->compile();
 		}
 	} else if (_port) {
@@ -102,8 +103,10 @@ Delete::pre_process()
 		_disconnect_event->pre_process();
 
 		if (parent->enabled()) {
-			_compiled_graph = parent->compile();
-			_ports_array    = parent->build_ports_array();
+			if (!_engine.pre_process_context().defer_compile(*parent)) {
+				_compiled_graph = parent->compile();
+			}
+			_ports_array = parent->build_ports_array();
 			assert(_ports_array->size() == parent->num_ports_non_rt());
 		}
 
@@ -47,26 +47,27 @@ namespace Events {
 
 typedef Resource::Properties Properties;
 
-Delta::Delta(Engine&           engine,
-             SPtr<Interface>   client,
-             int32_t           id,
-             SampleCount       timestamp,
-             Type              type,
-             Resource::Graph   context,
-             const Raul::URI&  subject,
-             const Properties& properties,
-             const Properties& remove)
+Delta::Delta(Engine&          engine,
+             SPtr<Interface>  client,
+             int32_t          id,
+             SampleCount      timestamp,
+             Type             type,
+             Resource::Graph  context,
+             const Raul::URI& subject,
+             Properties       properties,
+             Properties       remove)
 	: Event(engine, client, id, timestamp)
 	, _create_event(NULL)
 	, _subject(subject)
-	, _properties(properties)
-	, _remove(remove)
+	, _properties(std::move(properties))
+	, _remove(std::move(remove))
 	, _object(NULL)
 	, _graph(NULL)
 	, _compiled_graph(NULL)
 	, _state(NULL)
 	, _context(context)
 	, _type(type)
+	, _superseded(false)
 	, _poly_lock(engine.store()->mutex(), std::defer_lock)
 {
 	if (context != Resource::Graph::DEFAULT) {
@@ -78,14 +79,14 @@ Delta::Delta(Engine&           engine,
 #ifdef DUMP
 	std::cerr << "Delta " << subject << " : " << (int)context << " {" << std::endl;
 	typedef Resource::Properties::const_iterator iterator;
-	for (iterator i = properties.begin(); i != properties.end(); ++i) {
+	for (iterator i = _properties.begin(); i != _properties.end(); ++i) {
 		std::cerr << "    + " << i->first
 		          << " = " << engine.world()->forge().str(i->second)
 		          << " :: " << engine.world()->uri_map().unmap_uri(i->second.type())
 		          << std::endl;
 	}
 	typedef Resource::Properties::const_iterator iterator;
-	for (iterator i = remove.begin(); i != remove.end(); ++i) {
+	for (iterator i = _remove.begin(); i != _remove.end(); ++i) {
 		std::cerr << "    - " << i->first
 		          << " = " << engine.world()->forge().str(i->second)
 		          << " :: " << engine.world()->uri_map().unmap_uri(i->second.type())
@@ -103,6 +104,95 @@ Delta::~Delta()
 	delete _create_event;
 }
 
+bool
+Delta::is_concurrent() const
+{
+	/* Setting port values and canvas positions only modifies the subject
+	   itself, so may be done concurrently with anything unrelated. */
+	const Ingen::URIs& uris = _engine.world()->uris();
+	if (_type == Type::PUT || !Node::uri_is_path(_subject)) {
+		return false;
+	}
+
+	for (const Properties* props : { &_properties, &_remove }) {
+		for (const auto& p : *props) {
+			if (p.first != uris.ingen_value &&
+			    p.first != uris.ingen_canvasX &&
+			    p.first != uris.ingen_canvasY) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+bool
+Delta::is_value_set() const
+{
+	const Ingen::URIs& uris = _engine.world()->uris();
+	if (_type == Type::PUT || !Node::uri_is_path(_subject) ||
+	    _properties.size() != 1 ||
+	    _properties.begin()->first != uris.ingen_value ||
+	    _properties.begin()->second.type() != uris.forge.Float) {
+		return false;  // Events and other values are never redundant
+	}
+
+	for (const auto& r : _remove) {
+		if (r.first != uris.ingen_value) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+bool
+Delta::can_be_superseded() const
+{
+	if (!is_value_set()) {
+		return false;
+	}
+
+	// Every value sent to a sample accurate port must be applied
+	const SPtr<Store> store = _engine.store();
+	SharedLock        lock(store->mutex());
+	const PortImpl* const port = dynamic_cast<const PortImpl*>(
+		store->get(Node::uri_to_path(_subject)));
+
+	return !port || !port->is_sample_accurate();
+}
+
+bool
+Delta::is_superseded_by(const Event& ev) const
+{
+	const Delta* const delta = dynamic_cast<const Delta*>(&ev);
+
+	return (delta && delta->_subject == _subject &&
+	        delta->_context == _context &&
+	        is_value_set() && delta->is_value_set());
+}
+
+Raul::Path
+Delta::scope() const
+{
+	const Ingen::URIs& uris = _engine.world()->uris();
+	if (!Node::uri_is_path(_subject)) {
+		return Raul::Path("/");
+	}
+
+	// Duplicating an existing object reads the prototype as well
+	for (const Raul::URI& key : { uris.lv2_prototype, uris.ingen_prototype }) {
+		const auto p = _properties.find(key);
+		if (p != _properties.end() && uris.forge.is_uri(p->second) &&
+		    Node::uri_is_path(Raul::URI(uris.forge.str(p->second, false)))) {
+			return Raul::Path("/");
+		}
+	}
+
+	return Node::uri_to_path(_subject);
+}
+
 void
 Delta::add_set_event(const char* port_symbol,
                      const void* value,
@@ -176,6 +266,23 @@ get_file_node(LilvWorld* lworld, const URIs& uris, const Atom& value)
  * @endcode
  */
 
+/** @page protocol
+ * @subsection profiling Profiling
+ *
+ * The property ingen:profile on the engine can be used to enable or disable
+ * measuring the processing time of blocks.  While enabled, the engine
+ * periodically sets ingen:cpuLoad on every block and graph to the fraction of
+ * the available time it took to process.  For example:
+ *
+ * @code{.ttl}
+ * []
+ *     a patch:Set ;
+ *     patch:subject </> ;
+ *     patch:property ingen:profile ;
+ *     patch:value true .
+ * @endcode
+ */
+
 bool
 Delta::pre_process()
 {
@@ -187,6 +294,10 @@ Delta::pre_process()
 	const bool is_file         = (_subject.substr(0, 5) == "file:");
 	bool       poly_changed    = false;
 
+	if (_superseded) {
+		return Event::pre_process_done(Status::SUCCESS);
+	}
+
 	if (_type == Type::PUT && is_file) {
 		// Ensure type is Preset, the only supported file put
 		const auto t = _properties.find(uris.rdf_type);
@@ -225,7 +336,7 @@ Delta::pre_process()
 	}
 
 	// Take a writer lock while we modify the store
-	std::unique_lock<std::mutex> lock(_engine.store()->mutex());
+	std::unique_lock<SharedMutex> lock(_engine.store()->mutex());
 
 	_object = is_graph_object
 		? static_cast<Ingen::Resource*>(_engine.store()->get(Node::uri_to_path(_subject)))
@@ -253,7 +364,11 @@ Delta::pre_process()
 				path, _properties);
 		}
 		if (_create_event) {
-			if (_create_event->pre_process()) {
+			// Creation takes the lock itself to add the new object
+			lock.unlock();
+			const bool created = _create_event->pre_process();
+			lock.lock();
+			if (created) {
 				_object = _engine.store()->get(path);  // Get object for setting
 			} else {
 				return Event::pre_process_done(Status::CREATION_FAILED, _subject);
@@ -275,6 +390,10 @@ Delta::pre_process()
 			PortImpl* port = dynamic_cast<PortImpl*>(_object);
 			if (port)
 				_old_bindings = _engine.control_bindings()->remove(port);
+		} else if (key == uris.ingen_sampleAccurate) {
+			PortImpl* port = dynamic_cast<PortImpl*>(_object);
+			if (port)
+				port->set_sample_accurate(false);
 		}
 		if (_object) {
 			_object->remove_property(key, value);
@@ -329,6 +448,13 @@ Delta::pre_process()
 					} else {
 						_status = Status::BAD_VALUE_TYPE;
 					}
+				} else if (key == uris.ingen_sampleAccurate) {
+					if (value.type() == uris.forge.Bool) {
+						// Only read by the pre-processor, so set it now
+						port->set_sample_accurate(value.get<int32_t>());
+					} else {
+						_status = Status::BAD_VALUE_TYPE;
+					}
 				} else if (key == uris.ingen_value || key == uris.ingen_activity) {
 					SetPortValue* ev = new SetPortValue(
 						_engine, _request_client, _request_id, _time, port, value);
@@ -384,7 +510,8 @@ Delta::pre_process()
 					if (value.type() == uris.forge.Bool) {
 						op = SpecialType::ENABLE;
 						// FIXME: defer this until all other metadata has been processed
-						if (value.get<int32_t>() && !_graph->enabled())
+						if (value.get<int32_t>() && !_graph->enabled() &&
+						    !_engine.pre_process_context().defer_compile(*_graph))
 							_compiled_graph = _graph->compile();
 					} else {
 						_status = Status::BAD_VALUE_TYPE;
@@ -447,6 +574,12 @@ Delta::pre_process()
 			} else {
 				_status = Status::BAD_VALUE;
 			}
+		} else if (is_engine && key == uris.ingen_profile) {
+			if (value.type() == uris.forge.Bool) {
+				op = SpecialType::PROFILE;
+			} else {
+				_status = Status::BAD_VALUE_TYPE;
+			}
 		}
 
 		if (_status != Status::NOT_PREPARED) {
@@ -469,7 +602,7 @@ Delta::pre_process()
 void
 Delta::execute(ProcessContext& context)
 {
-	if (_status != Status::SUCCESS || _preset) {
+	if (_status != Status::SUCCESS || _preset || _superseded) {
 		return;
 	}
 
@@ -552,6 +685,9 @@ Delta::execute(ProcessContext& context)
 			}
 		case SpecialType::LOADED_BUNDLE:
 			break;
+		case SpecialType::PROFILE:
+			_engine.set_profiling(value.get<int32_t>());
+			break;
 		}
 	}
 }
@@ -572,6 +708,11 @@ Delta::post_process()
 		lilv_state_free(_state);
 	}
 
+	if (_superseded) {
+		respond();  // A later value will be broadcast instead
+		return;
+	}
+
 	Broadcaster::Transfer t(*_engine.broadcaster());
 
 	if (_create_event) {
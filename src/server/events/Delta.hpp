@@ -21,6 +21,7 @@
 
 #include <boost/optional.hpp>
 
+#include "ingen/SharedMutex.hpp"
 #include "lilv/lilv.h"
 
 #include "raul/URI.hpp"
@@ -56,15 +57,15 @@ public:
 		PATCH
 	};
 
-	Delta(Engine&                     engine,
-	      SPtr<Interface>             client,
-	      int32_t                     id,
-	      SampleCount                 timestamp,
-	      Type                        type,
-	      Resource::Graph             context,
-	      const Raul::URI&            subject,
-	      const Resource::Properties& properties,
-	      const Resource::Properties& remove = Resource::Properties());
+	Delta(Engine&              engine,
+	      SPtr<Interface>      client,
+	      int32_t              id,
+	      SampleCount          timestamp,
+	      Type                 type,
+	      Resource::Graph      context,
+	      const Raul::URI&     subject,
+	      Resource::Properties properties,
+	      Resource::Properties remove = Resource::Properties());
 
 	~Delta();
 
@@ -73,6 +74,12 @@ public:
 	                   uint32_t    size,
 	                   uint32_t    type);
 
+	bool       is_concurrent() const;
+	Raul::Path scope() const;
+	bool       can_be_superseded() const;
+	bool       is_superseded_by(const Event& ev) const;
+	void       supersede() { _superseded = true; }
+
 	bool pre_process();
 	void execute(ProcessContext& context);
 	void post_process();
@@ -86,11 +93,15 @@ private:
 		POLYPHONIC,
 		CONTROL_BINDING,
 		PRESET,
-		LOADED_BUNDLE
+		LOADED_BUNDLE,
+		PROFILE
 	};
 
 	typedef std::vector<SetPortValue*> SetEvents;
 
+	/** Return true iff this only sets the control value of a graph object. */
+	bool is_value_set() const;
+
 	Event*                   _create_event;
 	SetEvents                _set_events;
 	std::vector<SpecialType> _types;
@@ -106,12 +117,13 @@ private:
 	Resource::Graph          _context;
 	ControlBindings::Key     _binding;
 	Type                     _type;
+	bool                     _superseded;
 
 	SPtr<ControlBindings::Bindings> _old_bindings;
 
 	boost::optional<Resource> _preset;
 
-	std::unique_lock<std::mutex> _poly_lock;  ///< Long-term lock for poly changes
+	std::unique_lock<SharedMutex> _poly_lock;  ///< Long-term lock for poly changes
 };
 
 } // namespace Events
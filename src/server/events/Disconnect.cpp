@@ -112,7 +112,7 @@ Disconnect::Impl::Impl(Engine&     e,
 bool
 Disconnect::pre_process()
 {
-	std::unique_lock<std::mutex> lock(_engine.store()->mutex());
+	std::unique_lock<SharedMutex> lock(_engine.store()->mutex());
 
 	if (_tail_path.parent().parent() != _head_path.parent().parent()
 	    && _tail_path.parent() != _head_path.parent().parent()
@@ -164,7 +164,7 @@ Disconnect::pre_process()
 	                 dynamic_cast<OutputPort*>(tail),
 	                 dynamic_cast<InputPort*>(head));
 
-	if (_graph->enabled())
+	if (_graph->enabled() && !_engine.pre_process_context().defer_compile(*_graph))
 		_compiled_graph = _graph->compile();
 
 	return Event::pre_process_done(Status::SUCCESS);
@@ -81,7 +81,7 @@ DisconnectAll::~DisconnectAll()
 bool
 DisconnectAll::pre_process()
 {
-	std::unique_lock<std::mutex> lock(_engine.store()->mutex(), std::defer_lock);
+	std::unique_lock<SharedMutex> lock(_engine.store()->mutex(), std::defer_lock);
 
 	if (!_deleting) {
 		lock.lock();
@@ -136,7 +136,8 @@ DisconnectAll::pre_process()
 			                 dynamic_cast<InputPort*>(a->head())));
 	}
 
-	if (!_deleting && _parent->enabled())
+	if (!_deleting && _parent->enabled() &&
+	    !_engine.pre_process_context().defer_compile(*_parent))
 		_compiled_graph = _parent->compile();
 
 	return Event::pre_process_done(Status::SUCCESS);
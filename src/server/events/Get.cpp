@@ -23,8 +23,10 @@
 #include "BlockImpl.hpp"
 #include "Broadcaster.hpp"
 #include "BufferFactory.hpp"
+#include "CycleStats.hpp"
 #include "Driver.hpp"
 #include "Engine.hpp"
+#include "EventPool.hpp"
 #include "Get.hpp"
 #include "GraphImpl.hpp"
 #include "PluginImpl.hpp"
@@ -45,10 +47,25 @@ Get::Get(Engine&          engine,
 	, _plugin(NULL)
 {}
 
+bool
+Get::is_concurrent() const
+{
+	return Node::uri_is_path(_uri);
+}
+
+Raul::Path
+Get::scope() const
+{
+	if (Node::uri_is_path(_uri)) {
+		return Node::uri_to_path(_uri);
+	}
+	return Raul::Path("/");
+}
+
 bool
 Get::pre_process()
 {
-	std::unique_lock<std::mutex> lock(_engine.store()->mutex());
+	SharedLock lock(_engine.store()->mutex());
 
 	if (_uri == "ingen:/plugins") {
 		_plugins = _engine.block_factory()->plugins();
@@ -94,6 +111,19 @@ Get::post_process()
 				Raul::URI("ingen:/engine"),
 				uris.param_sampleRate,
 				uris.forge.make(int32_t(_engine.driver()->sample_rate())));
+
+			_request_client->set_property(
+				Raul::URI("ingen:/engine"),
+				uris.ingen_eventPoolSize,
+				uris.forge.make(int32_t(EventPool::n_allocations())));
+
+			CycleStats* const stats = _engine.driver()->cycle_stats();
+			if (stats) {
+				_request_client->set_property(
+					Raul::URI("ingen:/engine"),
+					uris.ingen_cycleStats,
+					uris.forge.alloc(stats->report()));
+			}
 		} else {
 			_response.send(_request_client.get());
 		}
@@ -47,6 +47,9 @@ public:
 	    SampleCount      timestamp,
 	    const Raul::URI& uri);
 
+	bool       is_concurrent() const;
+	Raul::Path scope() const;
+
 	bool pre_process();
 	void execute(ProcessContext& context) {}
 	void post_process();
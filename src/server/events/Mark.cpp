@@ -0,0 +1,96 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "CompiledGraph.hpp"
+#include "Engine.hpp"
+#include "GraphImpl.hpp"
+#include "PreProcessContext.hpp"
+#include "events/Mark.hpp"
+
+namespace Ingen {
+namespace Server {
+namespace Events {
+
+Mark::Mark(Engine&         engine,
+           SPtr<Interface> client,
+           int32_t         id,
+           SampleCount     timestamp,
+           Type            type)
+	: Event(engine, client, id, timestamp)
+	, _type(type)
+{}
+
+Mark::~Mark()
+{
+	for (auto& g : _compiled_graphs) {
+		delete g.second;
+	}
+}
+
+bool
+Mark::pre_process()
+{
+	PreProcessContext& ctx = _engine.pre_process_context();
+
+	switch (_type) {
+	case Type::BUNDLE_START:
+		ctx.bundle_begin();
+		break;
+	case Type::BUNDLE_END:
+		if (ctx.bundle_end()) {
+			// Compile every graph modified by the bundle exactly once
+			for (GraphImpl* graph : ctx.dirty_graphs()) {
+				_compiled_graphs.push_back(
+					std::make_pair(graph, graph->compile()));
+			}
+			ctx.dirty_graphs().clear();
+		}
+		break;
+	}
+
+	return Event::pre_process_done(Status::SUCCESS);
+}
+
+void
+Mark::execute(ProcessContext& context)
+{
+	for (auto& g : _compiled_graphs) {
+		g.first->set_compiled_graph(g.second);
+		g.second = NULL;  // Graph takes ownership
+	}
+}
+
+void
+Mark::post_process()
+{
+	respond();
+}
+
+Event::Execution
+Mark::get_execution() const
+{
+	switch (_type) {
+	case Type::BUNDLE_START:
+		return Execution::BLOCK;
+	case Type::BUNDLE_END:
+		return Execution::UNBLOCK;
+	}
+	return Execution::NORMAL;
+}
+
+} // namespace Events
+} // namespace Server
+} // namespace Ingen
@@ -0,0 +1,71 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEN_EVENTS_MARK_HPP
+#define INGEN_EVENTS_MARK_HPP
+
+#include <utility>
+#include <vector>
+
+#include "Event.hpp"
+
+namespace Ingen {
+namespace Server {
+
+class CompiledGraph;
+class GraphImpl;
+
+namespace Events {
+
+/** Mark the start or end of an atomic bundle.
+ *
+ * Graphs modified by the events in a bundle are compiled once, when the end
+ * mark is pre-processed, and the new compiled graphs are installed together
+ * when it is executed.
+ *
+ * \ingroup engine
+ */
+class Mark : public Event
+{
+public:
+	enum class Type { BUNDLE_START, BUNDLE_END };
+
+	Mark(Engine&         engine,
+	     SPtr<Interface> client,
+	     int32_t         id,
+	     SampleCount     timestamp,
+	     Type            type);
+
+	~Mark();
+
+	bool pre_process();
+	void execute(ProcessContext& context);
+	void post_process();
+
+	Execution get_execution() const;
+
+private:
+	typedef std::vector<std::pair<GraphImpl*, CompiledGraph*> > CompiledGraphs;
+
+	CompiledGraphs _compiled_graphs;
+	Type           _type;
+};
+
+} // namespace Events
+} // namespace Server
+} // namespace Ingen
+
+#endif // INGEN_EVENTS_MARK_HPP
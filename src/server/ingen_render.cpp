@@ -0,0 +1,72 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include <string>
+
+#include "ingen/Atom.hpp"
+#include "ingen/Configuration.hpp"
+#include "ingen/Log.hpp"
+#include "ingen/Module.hpp"
+#include "ingen/World.hpp"
+
+#include "Engine.hpp"
+#include "RenderDriver.hpp"
+
+using namespace std;
+using namespace Ingen;
+
+struct IngenRenderModule : public Ingen::Module {
+	IngenRenderModule() : driver(NULL) {}
+
+	void load(Ingen::World* world) {
+		Server::Engine* engine = (Server::Engine*)world->engine().get();
+		if (engine->driver()) {
+			world->log().warn("Engine already has a driver\n");
+			return;
+		}
+
+		Configuration& conf  = world->conf();
+		const Atom&    input = conf.option("render-input");
+
+		driver = new Server::RenderDriver(
+			*engine,
+			input.is_valid() ? input.ptr<char>() : "",
+			conf.option("render").ptr<char>(),
+			conf.option("render-rate").get<int32_t>(),
+			conf.option("render-block").get<int32_t>(),
+			16384);
+		engine->set_driver(SPtr<Server::Driver>(driver));
+	}
+
+	void run(Ingen::World* world) {
+		if (driver) {
+			driver->render(
+				world->conf().option("render-length").get<int32_t>());
+		}
+	}
+
+	Server::RenderDriver* driver;
+};
+
+extern "C" {
+
+Ingen::Module*
+ingen_module_load()
+{
+	return new IngenRenderModule();
+}
+
+} // extern "C"
@@ -0,0 +1,132 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEN_ENGINE_MERGE_HPP
+#define INGEN_ENGINE_MERGE_HPP
+
+#include <stdint.h>
+
+#include "lv2/lv2plug.in/ns/ext/atom/util.h"
+
+namespace Ingen {
+namespace Server {
+
+/** Merge several atom sequences into a single time-ordered stream.
+ *
+ * `sink` is called with every event of every sequence, in order of time.
+ * Events at the same time are emitted in the order of their sources, so
+ * merging is stable.
+ *
+ * Sources are kept in a binary heap keyed by the time of their next event,
+ * so each event costs O(log(n_seqs)) rather than a scan of every source.
+ * If only one source has any events at all, they are passed on directly, and
+ * if only a few do, they are simply scanned.
+ */
+template<typename Sink>
+inline void
+merge_sequences(const LV2_Atom_Sequence* const* seqs,
+                uint32_t                        n_seqs,
+                Sink                            sink)
+{
+	/** The next event in a source, and the source's index. */
+	struct Head {
+		const LV2_Atom_Event* ev;
+		uint32_t              src;
+	};
+
+	// Return true iff `a` must be emitted before `b`
+	const auto before = [](const Head& a, const Head& b) {
+		return a.ev->time.frames < b.ev->time.frames ||
+			(a.ev->time.frames == b.ev->time.frames && a.src < b.src);
+	};
+
+	// Return the event after `ev` in `seq`, or NULL at the end
+	const auto next = [](const LV2_Atom_Sequence* seq, const LV2_Atom_Event* ev) {
+		ev = lv2_atom_sequence_next(ev);
+		return lv2_atom_sequence_is_end(&seq->body, seq->atom.size, ev)
+			? NULL : ev;
+	};
+
+	// Find the first event of every non-empty source
+	Head     heap[n_seqs ? n_seqs : 1];
+	uint32_t n_heads = 0;
+	for (uint32_t i = 0; i < n_seqs; ++i) {
+		if (seqs[i]) {
+			const LV2_Atom_Event* ev = lv2_atom_sequence_begin(&seqs[i]->body);
+			if (!lv2_atom_sequence_is_end(&seqs[i]->body, seqs[i]->atom.size, ev)) {
+				heap[n_heads++] = { ev, i };
+			}
+		}
+	}
+
+	if (n_heads == 1) {
+		// Only one source has events, no merging necessary
+		for (const LV2_Atom_Event* ev = heap[0].ev; ev;) {
+			sink(ev);
+			ev = next(seqs[heap[0].src], ev);
+		}
+		return;
+	} else if (n_heads <= 4) {
+		// With only a few sources, scanning them is cheaper than a heap
+		while (n_heads > 0) {
+			uint32_t first = 0;
+			for (uint32_t i = 1; i < n_heads; ++i) {
+				if (before(heap[i], heap[first])) {
+					first = i;
+				}
+			}
+
+			sink(heap[first].ev);
+			if (!(heap[first].ev = next(seqs[heap[first].src], heap[first].ev))) {
+				heap[first] = heap[--n_heads];  // Source is finished
+			}
+		}
+		return;
+	}
+
+	// Move the head at `i` down the heap to its proper place
+	const auto sift_down = [&](uint32_t i) {
+		const Head h = heap[i];
+		for (uint32_t c; (c = 2 * i + 1) < n_heads; i = c) {
+			if (c + 1 < n_heads && before(heap[c + 1], heap[c])) {
+				++c;  // Right child is earlier
+			}
+			if (!before(heap[c], h)) {
+				break;
+			}
+			heap[i] = heap[c];
+		}
+		heap[i] = h;
+	};
+
+	for (uint32_t i = n_heads / 2; i-- > 0;) {
+		sift_down(i);
+	}
+
+	// Emit the earliest event and replace it with the next from that source
+	while (n_heads > 0) {
+		sink(heap[0].ev);
+		if (!(heap[0].ev = next(seqs[heap[0].src], heap[0].ev))) {
+			heap[0] = heap[--n_heads];  // Source is finished
+		}
+		sift_down(0);
+	}
+}
+
+} // namespace Server
+} // namespace Ingen
+
+#endif // INGEN_ENGINE_MERGE_HPP
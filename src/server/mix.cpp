@@ -18,20 +18,60 @@
 
 #include "Buffer.hpp"
 #include "Context.hpp"
+#include "merge.hpp"
 #include "mix.hpp"
+#include "sum.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#    define INGEN_MIX_X86 1
+#endif
 
 namespace Ingen {
 namespace Server {
 
-static inline bool
-is_end(const Buffer* buf, const LV2_Atom_Event* ev)
+typedef void (*SumAudioFunc)(Sample*              out,
+                             const Sample* const* srcs,
+                             uint32_t             n_srcs,
+                             Sample               constant,
+                             SampleCount          nframes);
+
+static void
+sum_audio_default(Sample*              out,
+                  const Sample* const* srcs,
+                  uint32_t             n_srcs,
+                  Sample               constant,
+                  SampleCount          nframes)
+{
+	sum_audio<SAMPLE_VECTOR_WIDTH>(out, srcs, n_srcs, constant, nframes);
+}
+
+#ifdef INGEN_MIX_X86
+__attribute__((target("avx")))
+static void
+sum_audio_avx(Sample*              out,
+              const Sample* const* srcs,
+              uint32_t             n_srcs,
+              Sample               constant,
+              SampleCount          nframes)
 {
-	const LV2_Atom* atom = buf->get<const LV2_Atom>();
-	return lv2_atom_sequence_is_end(
-		(const LV2_Atom_Sequence_Body*)LV2_ATOM_BODY_CONST(atom),
-		atom->size,
-		ev);
+	sum_audio<8>(out, srcs, n_srcs, constant, nframes);
 }
+#endif
+
+/** Choose the best kernel for the CPU we are running on. */
+static SumAudioFunc
+select_sum_audio()
+{
+#ifdef INGEN_MIX_X86
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx")) {
+		return sum_audio_avx;
+	}
+#endif
+	return sum_audio_default;
+}
+
+static const SumAudioFunc sum_audio_kernel = select_sum_audio();
 
 void
 mix(const Context&      context,
@@ -48,63 +88,43 @@ mix(const Context&      context,
 			out[0] += srcs[i]->value_at(0);
 		}
 	} else if (dst->is_audio()) {
-		// Copy the first source
-		dst->copy(context, srcs[0]);
+		// Gather audio sources, and sum control sources to add to every frame
+		const SampleCount offset   = context.offset();
+		const Sample*     audio[num_srcs];
+		uint32_t          n_audio  = 0;
+		Sample            constant = 0.0f;
+		for (uint32_t i = 0; i < num_srcs; ++i) {
+			if (srcs[i]->is_audio()) {  // audio => audio
+				audio[n_audio++] = srcs[i]->samples() + offset;
+			} else if (srcs[i]->is_control()) {  // control => audio
+				constant += srcs[i]->samples()[0];
+			}
+		}
 
-		// Mix in the rest
-		Sample* __restrict const out = dst->samples();
-		const SampleCount        end = context.nframes();
-		for (uint32_t i = 1; i < num_srcs; ++i) {
-			const Sample* __restrict const in = srcs[i]->samples();
-			if (srcs[i]->is_control()) {  // control => audio
-				for (SampleCount i = 0; i < end; ++i) {
-					out[i] += in[0];
-				}
-			} else if (srcs[i]->is_audio()) {  // audio => audio
-				for (SampleCount i = 0; i < end; ++i) {
-					out[i] += in[i];
-				}
-			} else if (srcs[i]->is_sequence()) {  // sequence => audio
+		// Mix them all down in as few passes as possible
+		sum_audio_kernel(
+			dst->samples() + offset, audio, n_audio, constant, context.nframes());
+
+		// Render sequences on top
+		for (uint32_t i = 0; i < num_srcs; ++i) {
+			if (srcs[i]->is_sequence()) {  // sequence => audio
 				dst->render_sequence(context, srcs[i], true);
 			}
 		}
 	} else if (dst->is_sequence()) {
-		const LV2_Atom_Event* iters[num_srcs];
+		const LV2_Atom_Sequence* seqs[num_srcs];
 		for (uint32_t i = 0; i < num_srcs; ++i) {
-			iters[i] = NULL;
+			seqs[i] = NULL;
 			if (srcs[i]->is_sequence()) {
-				const LV2_Atom_Sequence* seq = srcs[i]->get<const LV2_Atom_Sequence>();
-				iters[i] = lv2_atom_sequence_begin(&seq->body);
-				if (is_end(srcs[i], iters[i])) {
-					iters[i] = NULL;
-				}
+				seqs[i] = srcs[i]->get<const LV2_Atom_Sequence>();
 			}
 		}
 
-		while (true) {
-			const LV2_Atom_Event* first   = NULL;
-			uint32_t              first_i = 0;
-			for (uint32_t i = 0; i < num_srcs; ++i) {
-				const LV2_Atom_Event* const ev = iters[i];
-				if (!first || (ev && ev->time.frames < first->time.frames)) {
-					first   = ev;
-					first_i = i;
-				}
-			}
-
-			if (first) {
+		merge_sequences(seqs, num_srcs, [dst](const LV2_Atom_Event* ev) {
 				dst->append_event(
-					first->time.frames, first->body.size, first->body.type,
-					(const uint8_t*)LV2_ATOM_BODY_CONST(&first->body));
-
-				iters[first_i] = lv2_atom_sequence_next(first);
-				if (is_end(srcs[first_i], iters[first_i])) {
-					iters[first_i] = NULL;
-				}
-			} else {
-				break;
-			}
-		}
+					ev->time.frames, ev->body.size, ev->body.type,
+					(const uint8_t*)LV2_ATOM_BODY_CONST(&ev->body));
+			});
 	}
 }
 
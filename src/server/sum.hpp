@@ -0,0 +1,124 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef INGEN_ENGINE_SUM_HPP
+#define INGEN_ENGINE_SUM_HPP
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "types.hpp"
+
+namespace Ingen {
+namespace Server {
+
+/** A vector of `W` samples, which the compiler maps to SIMD registers. */
+template<unsigned W>
+struct SampleVector {
+#ifdef __GNUC__
+	typedef Sample Type __attribute__((vector_size(W * sizeof(Sample))));
+#endif
+};
+
+template<>
+struct SampleVector<1> {
+	typedef Sample Type;
+};
+
+#ifdef __GNUC__
+/* Kernels are always inlined into a dispatch function, so they are compiled
+   for whatever instruction set that function is built for. */
+#    define INGEN_MIX_INLINE __attribute__((always_inline)) inline
+#    define SAMPLE_VECTOR_WIDTH 4
+#else
+#    define INGEN_MIX_INLINE inline
+#    define SAMPLE_VECTOR_WIDTH 1
+#endif
+
+/** Add `N` sources to `out` (or set `out` to their sum plus `constant` if
+ * `first`), `W` samples at a time. */
+template<unsigned W, unsigned N, bool first>
+INGEN_MIX_INLINE void
+sum_pass(Sample* const              out,
+         const Sample* const* const in,
+         const Sample               constant,
+         const SampleCount          nframes)
+{
+	typedef typename SampleVector<W>::Type Vector;
+
+	const Vector init = Vector() + constant;
+
+	SampleCount i = 0;
+	for (; i + W <= nframes; i += W) {
+		Vector acc = init;
+		if (!first) {
+			memcpy(&acc, out + i, sizeof(Vector));
+		}
+		for (unsigned s = 0; s < N; ++s) {
+			Vector v;
+			memcpy(&v, in[s] + i, sizeof(Vector));
+			acc += v;
+		}
+		memcpy(out + i, &acc, sizeof(Vector));
+	}
+
+	for (; i < nframes; ++i) {
+		Sample acc = first ? constant : out[i];
+		for (unsigned s = 0; s < N; ++s) {
+			acc += in[s][i];
+		}
+		out[i] = acc;
+	}
+}
+
+/** Set `out` to `constant` plus the sum of all sources.
+ *
+ * Sources are summed four at a time, so a large bus makes a quarter as many
+ * passes over the output as adding each source separately.
+ */
+template<unsigned W>
+INGEN_MIX_INLINE void
+sum_audio(Sample* const              out,
+          const Sample* const* const srcs,
+          const uint32_t             n_srcs,
+          const Sample               constant,
+          const SampleCount          nframes)
+{
+	uint32_t s = std::min(n_srcs, 4u);
+	switch (s) {
+	case 0: sum_pass<W, 0, true>(out, srcs, constant, nframes); break;
+	case 1: sum_pass<W, 1, true>(out, srcs, constant, nframes); break;
+	case 2: sum_pass<W, 2, true>(out, srcs, constant, nframes); break;
+	case 3: sum_pass<W, 3, true>(out, srcs, constant, nframes); break;
+	case 4: sum_pass<W, 4, true>(out, srcs, constant, nframes); break;
+	}
+
+	for (; s + 4 <= n_srcs; s += 4) {
+		sum_pass<W, 4, false>(out, srcs + s, 0.0f, nframes);
+	}
+
+	switch (n_srcs - s) {
+	case 1: sum_pass<W, 1, false>(out, srcs + s, 0.0f, nframes); break;
+	case 2: sum_pass<W, 2, false>(out, srcs + s, 0.0f, nframes); break;
+	case 3: sum_pass<W, 3, false>(out, srcs + s, 0.0f, nframes); break;
+	}
+}
+
+} // namespace Server
+} // namespace Ingen
+
+#endif // INGEN_ENGINE_SUM_HPP
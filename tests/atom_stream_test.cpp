@@ -0,0 +1,268 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Test for atom stream framing.
+ *
+ * Messages are written by a stream with its own URID map, standing in for
+ * another process, and read by a stream using the world's map, checking that
+ * they arrive intact.  Malformed and truncated frames, which may come from an
+ * untrusted peer, must be rejected.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <deque>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glibmm/thread.h>
+
+#include "ingen/AtomStream.hpp"
+#include "ingen/URIMap.hpp"
+#include "ingen/World.hpp"
+#include "ingen/runtime_paths.hpp"
+#include "lv2/lv2plug.in/ns/ext/atom/forge.h"
+#include "lv2/lv2plug.in/ns/ext/atom/util.h"
+#include "lv2/lv2plug.in/ns/ext/patch/patch.h"
+
+using namespace std;
+using namespace Ingen;
+
+/** First URID of the remote map, so remote and local URIDs differ. */
+static const LV2_URID REMOTE_BASE = 1000;
+
+World* world = NULL;
+
+static LV2_URID
+remote_map(LV2_URID_Map_Handle handle, const char* uri)
+{
+	std::deque<std::string>& uris = *(std::deque<std::string>*)handle;
+	for (size_t i = 0; i < uris.size(); ++i) {
+		if (uris[i] == uri) {
+			return REMOTE_BASE + i;
+		}
+	}
+	uris.push_back(uri);
+	return REMOTE_BASE + uris.size() - 1;
+}
+
+static const char*
+remote_unmap(LV2_URID_Unmap_Handle handle, LV2_URID urid)
+{
+	std::deque<std::string>& uris = *(std::deque<std::string>*)handle;
+	if (urid < REMOTE_BASE || urid - REMOTE_BASE >= uris.size()) {
+		return NULL;
+	}
+	return uris[urid - REMOTE_BASE].c_str();
+}
+
+static void
+test_try(bool cond, const char* msg)
+{
+	if (!cond) {
+		cerr << "atom_stream_test: Error: " << msg << endl;
+		delete world;
+		exit(EXIT_FAILURE);
+	}
+}
+
+/** Read every frame in `bytes`, returning the last message, if any. */
+static std::vector<uint64_t>
+read_frames(AtomStream& stream, const std::vector<uint8_t>& bytes)
+{
+	std::vector<uint64_t> frame;
+	std::vector<uint64_t> msg;
+	for (size_t offset = 0; offset < bytes.size();) {
+		LV2_Atom head;
+		test_try(bytes.size() - offset >= sizeof(head), "Truncated frame");
+		memcpy(&head, &bytes[offset], sizeof(head));
+
+		const uint32_t size = sizeof(LV2_Atom) + lv2_atom_pad_size(head.size);
+		test_try(bytes.size() - offset >= size, "Truncated frame body");
+
+		frame.resize(size / sizeof(uint64_t));
+		memcpy(frame.data(), &bytes[offset], size);
+		offset += size;
+
+		if (stream.read((LV2_Atom*)frame.data(), size)) {
+			msg = frame;
+		} else {
+			test_try(head.type == 0, "Failed to read message");
+		}
+	}
+	return msg;
+}
+
+/** Return a copy of `atom` in a buffer suitable for AtomStream::read(). */
+static std::vector<uint64_t>
+frame_of(const LV2_Atom* atom)
+{
+	const uint32_t size = sizeof(LV2_Atom) + lv2_atom_pad_size(atom->size);
+	std::vector<uint64_t> frame(size / sizeof(uint64_t), 0);
+	memcpy(frame.data(), atom, sizeof(LV2_Atom) + atom->size);
+	return frame;
+}
+
+int
+main(int argc, char** argv)
+{
+	Glib::thread_init();
+	set_bundle_path_from_code((void*)&main);
+
+	try {
+		world = new World(argc, argv, NULL, NULL, NULL);
+	} catch (std::exception& e) {
+		cout << "ingen: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	std::deque<std::string> remote_uris;
+	LV2_URID_Map            map   = { &remote_uris, remote_map };
+	LV2_URID_Unmap          unmap = { &remote_uris, remote_unmap };
+	URIMap                  remote(world->log(), &map, &unmap);
+	URIMap&                 local = world->uri_map();
+
+	AtomStream writer(remote);
+	AtomStream reader(local);
+
+	// Forge a message with the remote map
+	uint8_t        buf[256];
+	LV2_Atom_Forge forge;
+	lv2_atom_forge_init(&forge, &map);
+	lv2_atom_forge_set_buffer(&forge, buf, sizeof(buf));
+
+	const LV2_URID patch_Set      = map.map(map.handle, LV2_PATCH__Set);
+	const LV2_URID patch_subject  = map.map(map.handle, LV2_PATCH__subject);
+	const LV2_URID patch_property = map.map(map.handle, LV2_PATCH__property);
+	const LV2_URID patch_value    = map.map(map.handle, LV2_PATCH__value);
+	const LV2_URID ingen_value    = map.map(map.handle, INGEN__value);
+
+	LV2_Atom_Forge_Frame obj;
+	lv2_atom_forge_object(&forge, &obj, 0, patch_Set);
+	lv2_atom_forge_key(&forge, patch_subject);
+	lv2_atom_forge_urid(&forge, map.map(map.handle, "ingen:/main/block/port"));
+	lv2_atom_forge_key(&forge, patch_property);
+	lv2_atom_forge_urid(&forge, ingen_value);
+	lv2_atom_forge_key(&forge, patch_value);
+	lv2_atom_forge_float(&forge, 0.5f);
+	lv2_atom_forge_pop(&forge, &obj);
+
+	// Keep a copy, since buf is reused for other messages below
+	const std::vector<uint64_t> original = frame_of((const LV2_Atom*)buf);
+	const LV2_Atom* const       msg      = (const LV2_Atom*)original.data();
+
+	// Round trip, URIDs must be translated to local ones
+	std::vector<uint8_t> out;
+	test_try(writer.write(msg, out), "Failed to write message");
+	std::vector<uint64_t> received = read_frames(reader, out);
+	test_try(!received.empty(), "Message not received");
+
+	const LV2_Atom_Object* const got = (const LV2_Atom_Object*)received.data();
+	const LV2_Atom*              value = NULL;
+	const LV2_Atom*              property = NULL;
+	lv2_atom_object_get(got,
+	                    local.map_uri(LV2_PATCH__value), &value,
+	                    local.map_uri(LV2_PATCH__property), &property,
+	                    0);
+	test_try(got->atom.type == local.map_uri(LV2_ATOM__Object),
+	         "Wrong message type");
+	test_try(got->body.otype == local.map_uri(LV2_PATCH__Set),
+	         "Wrong object type");
+	test_try(value && value->type == local.map_uri(LV2_ATOM__Float) &&
+	         ((const LV2_Atom_Float*)value)->body == 0.5f,
+	         "Wrong value");
+	test_try(property && property->type == local.map_uri(LV2_ATOM__URID) &&
+	         ((const LV2_Atom_URID*)property)->body ==
+	         local.map_uri(INGEN__value),
+	         "Wrong property");
+
+	// URIDs are only declared once
+	const size_t first_size = out.size();
+	out.clear();
+	test_try(writer.write(msg, out), "Failed to write message again");
+	test_try(out.size() == sizeof(LV2_Atom) + lv2_atom_pad_size(msg->size),
+	         "URIDs declared again");
+	test_try(out.size() < first_size, "Declarations missing");
+	test_try(!read_frames(reader, out).empty(), "Second message not received");
+
+	/* A message with an unknown URID is not written, and does not mark the
+	   other new URIDs in it as declared. */
+	LV2_Atom_Forge_Frame bad;
+	lv2_atom_forge_set_buffer(&forge, buf, sizeof(buf));
+	lv2_atom_forge_object(&forge, &bad, 0, patch_Set);
+	lv2_atom_forge_key(&forge, map.map(map.handle, "urn:test:new"));
+	lv2_atom_forge_urid(&forge, REMOTE_BASE + 9999);
+	lv2_atom_forge_pop(&forge, &bad);
+	out.clear();
+	test_try(!writer.write((const LV2_Atom*)buf, out), "Wrote unknown URID");
+	test_try(out.empty(), "Partial message written");
+
+	LV2_Atom_Forge_Frame good;
+	lv2_atom_forge_set_buffer(&forge, buf, sizeof(buf));
+	lv2_atom_forge_object(&forge, &good, 0, patch_Set);
+	lv2_atom_forge_key(&forge, map.map(map.handle, "urn:test:new"));
+	lv2_atom_forge_int(&forge, 1);
+	lv2_atom_forge_pop(&forge, &good);
+	test_try(writer.write((const LV2_Atom*)buf, out), "Failed to write");
+	test_try(!read_frames(reader, out).empty(), "Declaration was lost");
+
+	// Messages with undeclared URIDs are rejected
+	const uint32_t        frame_size = original.size() * sizeof(uint64_t);
+	AtomStream            fresh(local);
+	std::vector<uint64_t> frame = original;
+	test_try(!fresh.read((LV2_Atom*)frame.data(), frame_size),
+	         "Read undeclared URID");
+
+	// Truncated frames are rejected
+	frame = original;
+	test_try(!reader.read((LV2_Atom*)frame.data(), sizeof(LV2_Atom) - 1),
+	         "Read truncated header");
+	test_try(!reader.read((LV2_Atom*)frame.data(), sizeof(LV2_Atom) + 8),
+	         "Read truncated body");
+
+	// A property that overruns its object is rejected
+	frame = original;
+	LV2_Atom_Object*        o    = (LV2_Atom_Object*)frame.data();
+	LV2_Atom_Property_Body* prop = lv2_atom_object_begin(&o->body);
+	prop->value.size = 1 << 20;
+	test_try(!reader.read((LV2_Atom*)frame.data(), frame_size),
+	         "Read overrunning property");
+
+	// A huge size is rejected
+	frame = original;
+	((LV2_Atom*)frame.data())->size = 0xFFFFFFFF;
+	test_try(!reader.read((LV2_Atom*)frame.data(), frame_size),
+	         "Read oversized atom");
+
+	// A declaration without a terminated URI is ignored
+	uint64_t        decl[3] = { 0, 0, 0 };
+	LV2_Atom* const d       = (LV2_Atom*)decl;
+	uint32_t* const body    = (uint32_t*)(d + 1);
+	d->size = 2 * sizeof(uint32_t);
+	body[0] = REMOTE_BASE + 500;
+	memset(body + 1, 'x', sizeof(uint32_t));
+	reader.read(d, sizeof(decl));
+	frame         = original;
+	o             = (LV2_Atom_Object*)frame.data();
+	o->body.otype = REMOTE_BASE + 500;
+	test_try(!reader.read((LV2_Atom*)frame.data(), frame_size),
+	         "Unterminated declaration was recorded");
+
+	delete world;
+	return 0;
+}
@@ -0,0 +1,144 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Test for limiting the time spent executing events in a cycle.
+ *
+ * A flood of values is sent to a sample accurate port, so none are dropped,
+ * and given time to be prepared.  With a small --event-budget, they must be
+ * spread over several cycles rather than all executed in the first, but
+ * every cycle must still make progress until all are executed.
+ */
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <glibmm/thread.h>
+
+#include "raul/Path.hpp"
+
+#include "ingen/EngineBase.hpp"
+#include "ingen/Interface.hpp"
+#include "ingen/Node.hpp"
+#include "ingen/URIs.hpp"
+#include "ingen/World.hpp"
+#include "ingen/runtime_paths.hpp"
+#include "ingen/types.hpp"
+
+using namespace std;
+using namespace Ingen;
+
+static const unsigned n_events     = 5000;
+static const uint32_t block_length = 64;
+
+World* world = NULL;
+
+static void
+test_try(bool cond, const char* msg)
+{
+	if (!cond) {
+		cerr << "event_budget_test: Error: " << msg << endl;
+		delete world;
+		exit(EXIT_FAILURE);
+	}
+}
+
+/** Run the engine until every event sent so far has been processed. */
+static void
+settle()
+{
+	while (world->engine()->pending_events()) {
+		world->engine()->run(block_length);
+		world->engine()->main_iteration();
+	}
+}
+
+int
+main(int, char** argv)
+{
+	Glib::thread_init();
+	set_bundle_path_from_code((void*)&main);
+
+	// Create world, allowing 1% of the period for events
+	const char* args[]  = { argv[0], "--event-budget", "1", NULL };
+	int         n_args  = 3;
+	char**      arg_ptr = (char**)args;
+	try {
+		world = new World(n_args, arg_ptr, NULL, NULL, NULL);
+	} catch (std::exception& e) {
+		cout << "ingen: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Load modules
+	test_try(world->load_module("server_profiled"),
+	         "Unable to load server module");
+
+	// Initialise engine
+	test_try(bool(world->engine()), "Unable to create engine");
+	world->engine()->init(48000.0, block_length, 4096);
+	world->engine()->activate();
+
+	// Create a graph with a sample accurate control input
+	Interface&      iface = *world->interface();
+	const URIs&     uris  = world->uris();
+	const Raul::URI port  = Node::path_to_uri(Raul::Path("/budget/in"));
+
+	Resource::Properties props;
+	props.insert(make_pair(uris.rdf_type,
+	                       Resource::Property(uris.ingen_Graph)));
+	iface.put(Node::path_to_uri(Raul::Path("/budget")), props);
+
+	Resource::Properties port_props;
+	port_props.insert(make_pair(uris.rdf_type,
+	                            Resource::Property(uris.lv2_InputPort)));
+	port_props.insert(make_pair(uris.rdf_type,
+	                            Resource::Property(uris.lv2_ControlPort)));
+	port_props.insert(make_pair(uris.ingen_sampleAccurate,
+	                            Resource::Property(uris.forge.make(true))));
+	iface.put(port, port_props);
+	settle();
+
+	// Send a flood of values, and wait for them to be prepared
+	for (unsigned i = 0; i < n_events; ++i) {
+		iface.set_property(port, uris.ingen_value, uris.forge.make(float(i)));
+	}
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+
+	// Run the engine until every event is executed
+	unsigned n_cycles   = 0;
+	unsigned n_executed = 0;
+	while (world->engine()->pending_events()) {
+		const unsigned n = world->engine()->run(block_length);
+		test_try(n > 0 || n_executed == n_events, "Cycle executed no events");
+		test_try(n < n_events, "Every event executed in a single cycle");
+
+		n_executed += n;
+		++n_cycles;
+		world->engine()->main_iteration();
+	}
+
+	test_try(n_executed == n_events, "Not every event was executed");
+	test_try(n_cycles > 1, "Events were not spread over several cycles");
+
+	// Shut down
+	world->engine()->deactivate();
+
+	delete world;
+	return 0;
+}
@@ -0,0 +1,228 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Benchmark for graph edit latency.
+ *
+ * This builds chains of internal delay blocks of increasing length, and times
+ * how long it takes the engine to fully process edits to them.  Edits are
+ * either a disconnect and reconnect of a random arc, rotating the chain at a
+ * random arc (which forces the execution order to be rearranged), or
+ * inserting a new block into the middle of the chain and deleting it again,
+ * either as separate events or as a single atomic bundle.
+ */
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <glibmm/thread.h>
+
+#include "raul/Path.hpp"
+
+#include "ingen/EngineBase.hpp"
+#include "ingen/Interface.hpp"
+#include "ingen/Node.hpp"
+#include "ingen/URIs.hpp"
+#include "ingen/World.hpp"
+#include "ingen/runtime_paths.hpp"
+#include "ingen/types.hpp"
+
+using namespace std;
+using namespace Ingen;
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* const delay_uri =
+	"http://drobilla.net/ns/ingen-internals#Delay";
+
+World* world = NULL;
+
+static void
+ingen_try(bool cond, const char* msg)
+{
+	if (!cond) {
+		cerr << "ingen: Error: " << msg << endl;
+		delete world;
+		exit(EXIT_FAILURE);
+	}
+}
+
+/** Run the engine until every event sent so far has been processed. */
+static void
+settle()
+{
+	while (world->engine()->pending_events()) {
+		world->engine()->run(4096);
+		world->engine()->main_iteration();
+	}
+	world->engine()->main_iteration();
+}
+
+static Raul::Path
+block_path(const Raul::Path& graph, unsigned i)
+{
+	return graph.child(Raul::Symbol("d" + std::to_string(i)));
+}
+
+static void
+create_block(Interface& iface, const Raul::Path& path)
+{
+	const URIs& uris = world->uris();
+
+	Resource::Properties props;
+	props.insert(make_pair(uris.rdf_type,
+	                       Resource::Property(uris.ingen_Block)));
+	props.insert(make_pair(uris.lv2_prototype,
+	                       uris.forge.make_urid(Raul::URI(delay_uri))));
+	iface.put(Node::path_to_uri(path), props);
+}
+
+static void
+connect(Interface& iface, const Raul::Path& tail, const Raul::Path& head)
+{
+	iface.connect(tail.child(Raul::Symbol("out")),
+	              head.child(Raul::Symbol("in")));
+}
+
+static void
+disconnect(Interface& iface, const Raul::Path& tail, const Raul::Path& head)
+{
+	iface.disconnect(tail.child(Raul::Symbol("out")),
+	                 head.child(Raul::Symbol("in")));
+}
+
+/** Return the mean time in microseconds to process each edit. */
+template<typename Edit>
+static double
+time_edits(unsigned n_edits, Edit edit)
+{
+	const Clock::time_point start = Clock::now();
+	for (unsigned e = 0; e < n_edits; ++e) {
+		edit(e);
+		settle();
+	}
+	const Clock::duration elapsed = Clock::now() - start;
+
+	return std::chrono::duration<double, std::micro>(elapsed).count()
+		/ n_edits;
+}
+
+static void
+bench(Interface& iface, unsigned n_blocks, unsigned n_edits)
+{
+	const URIs&      uris = world->uris();
+	const Raul::Path graph("/bench" + std::to_string(n_blocks));
+
+	/* Build a chain of blocks in a new subgraph.  Blocks are created last
+	   first, so every arc goes against the initial order. */
+	Resource::Properties props;
+	props.insert(make_pair(uris.rdf_type,
+	                       Resource::Property(uris.ingen_Graph)));
+	iface.put(Node::path_to_uri(graph), props);
+	for (unsigned i = n_blocks; i > 0; --i) {
+		create_block(iface, block_path(graph, i - 1));
+	}
+	for (unsigned i = 1; i < n_blocks; ++i) {
+		connect(iface, block_path(graph, i - 1), block_path(graph, i));
+	}
+	settle();
+
+	// Break and remake a random arc in the chain
+	const double reconnect = time_edits(n_edits, [&](unsigned) {
+			const unsigned i = rand() % (n_blocks - 1);
+			disconnect(iface, block_path(graph, i), block_path(graph, i + 1));
+			connect(iface, block_path(graph, i), block_path(graph, i + 1));
+		});
+
+	/* Move the head of the chain after its tail by breaking a random arc,
+	   then move it back, so the order must be rearranged twice */
+	const Raul::Path first = block_path(graph, 0);
+	const Raul::Path last  = block_path(graph, n_blocks - 1);
+	const double     rotate = time_edits(n_edits, [&](unsigned) {
+			const unsigned i = rand() % (n_blocks - 1);
+			disconnect(iface, block_path(graph, i), block_path(graph, i + 1));
+			connect(iface, last, first);
+			disconnect(iface, last, first);
+			connect(iface, block_path(graph, i), block_path(graph, i + 1));
+		});
+
+	// Insert a new block after a random block, then remove it
+	const double insert = time_edits(n_edits, [&](unsigned) {
+			const unsigned   i = rand() % (n_blocks - 1);
+			const Raul::Path x = graph.child(Raul::Symbol("x"));
+			create_block(iface, x);
+			connect(iface, block_path(graph, i), x);
+			connect(iface, x, block_path(graph, i + 1));
+			iface.del(Node::path_to_uri(x));
+		});
+
+	// The same insertion as a single atomic bundle, which compiles once
+	const double bundled = time_edits(n_edits, [&](unsigned) {
+			const unsigned   i = rand() % (n_blocks - 1);
+			const Raul::Path x = graph.child(Raul::Symbol("x"));
+			iface.bundle_begin();
+			create_block(iface, x);
+			connect(iface, block_path(graph, i), x);
+			connect(iface, x, block_path(graph, i + 1));
+			iface.del(Node::path_to_uri(x));
+			iface.bundle_end();
+		});
+
+	cout << n_blocks << "\t" << reconnect << "\t" << rotate
+	     << "\t" << insert << "\t" << bundled << endl;
+
+	iface.del(Node::path_to_uri(graph));
+	settle();
+}
+
+int
+main(int argc, char** argv)
+{
+	Glib::thread_init();
+	set_bundle_path_from_code((void*)&main);
+
+	// Create world
+	try {
+		world = new World(argc, argv, NULL, NULL, NULL);
+	} catch (std::exception& e) {
+		cout << "ingen: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Load modules
+	ingen_try(world->load_module("server_profiled"),
+	          "Unable to load server module");
+
+	// Initialise engine
+	ingen_try(bool(world->engine()),
+	          "Unable to create engine");
+	world->engine()->init(48000.0, 4096, 4096);
+	world->engine()->activate();
+
+	cout << "# blocks\treconnect (us)\trotate (us)\tinsert (us)"
+	     << "\tbundled insert (us)" << endl;
+	for (unsigned n_blocks : { 10, 100, 500, 1000, 2000, 5000 }) {
+		bench(*world->interface(), n_blocks, 100);
+	}
+
+	// Shut down
+	world->engine()->deactivate();
+
+	delete world;
+	return 0;
+}
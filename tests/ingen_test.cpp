@@ -14,11 +14,14 @@
   along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
 */
 
+#include <math.h>
 #include <signal.h>
 #include <stdlib.h>
 
 #include <iostream>
+#include <map>
 #include <string>
+#include <utility>
 
 #include <boost/optional.hpp>
 
@@ -40,9 +43,11 @@
 #include "ingen/Configuration.hpp"
 #include "ingen/Configuration.hpp"
 #include "ingen/EngineBase.hpp"
+#include "ingen/Forge.hpp"
 #include "ingen/Interface.hpp"
 #include "ingen/Parser.hpp"
 #include "ingen/URIMap.hpp"
+#include "ingen/URIs.hpp"
 #include "ingen/World.hpp"
 #include "ingen/client/ThreadedSigClientInterface.hpp"
 #include "ingen/runtime_paths.hpp"
@@ -67,11 +72,19 @@ public:
 
 	void put(const Raul::URI&            uri,
 	         const Resource::Properties& properties,
-	         Resource::Graph             ctx = Resource::Graph::DEFAULT) {}
+	         Resource::Graph             ctx = Resource::Graph::DEFAULT) {
+		for (const auto& p : properties) {
+			_values[Key(uri, p.first)] = p.second;
+		}
+	}
 
 	void delta(const Raul::URI&            uri,
 	           const Resource::Properties& remove,
-	           const Resource::Properties& add) {}
+	           const Resource::Properties& add) {
+		for (const auto& p : add) {
+			_values[Key(uri, p.first)] = p.second;
+		}
+	}
 
 	void copy(const Raul::URI& old_uri,
 	          const Raul::URI& new_uri) {}
@@ -92,7 +105,9 @@ public:
 
 	void set_property(const Raul::URI& subject,
 	                  const Raul::URI& predicate,
-	                  const Atom&      value) {}
+	                  const Atom&      value) {
+		_values[Key(subject, predicate)] = value;
+	}
 
 	void set_response_id(int32_t id) {}
 
@@ -111,8 +126,18 @@ public:
 		exit(EXIT_FAILURE);
 	}
 
+	/** Return the last value of a property sent by the engine, or NULL. */
+	const Atom* value(const Raul::URI& subject, const Raul::URI& predicate) {
+		const Values::const_iterator i = _values.find(Key(subject, predicate));
+		return (i == _values.end()) ? NULL : &i->second;
+	}
+
 private:
-	Log& _log;
+	typedef std::pair<Raul::URI, Raul::URI> Key;
+	typedef std::map<Key, Atom>             Values;
+
+	Log&   _log;
+	Values _values;
 };
 
 
@@ -126,6 +151,37 @@ ingen_try(bool cond, const char* msg)
 	}
 }
 
+/** Run the engine until every enqueued event has been executed. */
+static void
+wait_for_engine()
+{
+	while (world->engine()->pending_events()) {
+		world->engine()->run(4096);
+		world->engine()->main_iteration();
+		g_usleep(1000);
+	}
+}
+
+/** Return true iff `value` is the literal or URI `expected`.
+ *
+ * Numbers are compared with a small tolerance, since values in the engine
+ * are single precision.
+ */
+static bool
+matches(const Atom& value, const Sord::Node& expected)
+{
+	Forge&            forge = world->forge();
+	const std::string str   = expected.to_string();
+	if (value.type() == forge.Float) {
+		return fabs(value.get<float>() - strtod(str.c_str(), NULL)) < 1.0e-4;
+	} else if (value.type() == forge.Int) {
+		return value.get<int32_t>() == atoi(str.c_str());
+	} else if (value.type() == forge.Bool) {
+		return str == (value.get<int32_t>() ? "true" : "false");
+	}
+	return forge.str(value, false) == str;
+}
+
 int
 main(int argc, char** argv)
 {
@@ -169,11 +225,7 @@ main(int argc, char** argv)
 		cerr << "error: failed to load initial graph " << start_graph << endl;
 		return 1;
 	}
-	while (world->engine()->pending_events()) {
-		world->engine()->run(4096);
-		world->engine()->main_iteration();
-		g_usleep(1000);
-	}
+	wait_for_engine();
 
 	// Read commands
 
@@ -195,7 +247,7 @@ main(int argc, char** argv)
 	                       *world->interface().get());
 
 	// AtomWriter to serialise responses from the engine
-	SPtr<Interface> client(new TestClient(world->log()));
+	SPtr<TestClient> client(new TestClient(world->log()));
 
 	world->interface()->set_respondee(client);
 	world->engine()->register_client(client);
@@ -208,11 +260,41 @@ main(int argc, char** argv)
 	                                    (const char*)cmds_file_uri.buf);
 	SerdEnv* env = serd_env_new(&cmds_file_uri);
 	cmds->load_file(env, SERD_TURTLE, cmds_file_path);
+	const URIs&     uris = world->uris();
+	const Sord::URI rdf_type(*world->rdf_world(), uris.rdf_type);
+	const Sord::URI patch_property(*world->rdf_world(), uris.patch_property);
+	const Sord::URI patch_subject(*world->rdf_world(), uris.patch_subject);
+	const Sord::URI patch_value(*world->rdf_world(), uris.patch_value);
+	const Sord::URI patch_Set(*world->rdf_world(), uris.patch_Set);
+	const Sord::URI ingen_value(*world->rdf_world(), uris.ingen_value);
+
+	// Return the resource named like "msg0" in the commands file
+	auto resource = [&](const char* prefix, int i) {
+		return Sord::URI(*world->rdf_world(),
+		                 (fmt("%1%%2%") % prefix % i).str(),
+		                 (const char*)cmds_file_uri.buf);
+	};
+
+	// Return true iff the commands file contains a matching statement
 	Sord::Node nil;
+	auto has = [&](const Sord::Node& s, const Sord::Node& p, const Sord::Node& o) {
+		return !cmds->find(s, p, o).end();
+	};
+
+	// Return the (first) object of `subject` and `predicate`, or null
+	auto get = [&](const Sord::Node& subject, const Sord::Node& predicate) {
+		Sord::Iter i = cmds->find(subject, predicate, nil);
+		return i.end() ? nil : i.get_object();
+	};
+
+	// Return true iff `msg` is a patch:Set of a port value
+	auto is_value_set = [&](const Sord::Node& msg) {
+		return (has(msg, rdf_type, patch_Set) &&
+		        has(msg, patch_property, ingen_value));
+	};
+
 	for (int i = 0; ; ++i) {
-		std::string subject_str = (fmt("msg%1%") % i).str();
-		Sord::URI subject(*world->rdf_world(), subject_str,
-		                  (const char*)cmds_file_uri.buf);
+		const Sord::URI subject = resource("msg", i);
 		Sord::Iter iter = cmds->find(subject, nil, nil);
 		if (iter.end()) {
 			break;
@@ -236,10 +318,35 @@ main(int argc, char** argv)
 			return EXIT_FAILURE;
 		}
 
-		while (world->engine()->pending_events()) {
-			world->engine()->run(4096);
-			world->engine()->main_iteration();
-			g_usleep(1000);
+		/* Send consecutive port values without waiting, like a client that
+		   sends values faster than the engine runs, so they may arrive in
+		   the same batch of events. */
+		const Sord::URI check = resource("check", i);
+		if (!has(check, patch_subject, nil) &&
+		    is_value_set(subject) && is_value_set(resource("msg", i + 1))) {
+			continue;
+		}
+
+		wait_for_engine();
+
+		/* Check that the engine has sent the expected value for a property,
+		   which is done after the engine has run the cycle that executed the
+		   message, so values must be correct immediately. */
+		if (has(check, patch_subject, nil)) {
+			const Sord::Node c_subject  = get(check, patch_subject);
+			const Sord::Node c_property = get(check, patch_property);
+			const Sord::Node c_value    = get(check, patch_value);
+			const Atom*      value      = client->value(
+				Raul::URI(c_subject.to_string()),
+				Raul::URI(c_property.to_string()));
+			if (!value || !matches(*value, c_value)) {
+				cerr << "error: check " << i << " failed: "
+				     << c_subject.to_string() << " "
+				     << c_property.to_string() << " is "
+				     << (value ? world->forge().str(*value, false) : "unset")
+				     << ", expected " << c_value.to_string() << endl;
+				return EXIT_FAILURE;
+			}
 		}
 	}
 	free((void*)out.buf);
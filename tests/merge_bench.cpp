@@ -0,0 +1,177 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Microbenchmark for merging event sequences when mixing ports.
+ *
+ * This times merging sequences of MIDI-sized events from 1 to 256 sources
+ * with merge_sequences(), compared to scanning every source for the earliest
+ * event (the simple approach it replaced), and checks that both agree.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "lv2/lv2plug.in/ns/ext/atom/util.h"
+
+#include "../src/server/merge.hpp"
+
+using namespace std;
+using namespace Ingen::Server;
+
+typedef std::chrono::steady_clock Clock;
+
+static const uint32_t events_per_source = 64;
+static const uint32_t nframes           = 1024;
+
+/** Sum of merged event times, so merging can not be optimised away. */
+static volatile int64_t total = 0;
+
+/** Build a sequence of 3-byte events at random times. */
+static std::vector<uint64_t>
+make_sequence(uint32_t n_events)
+{
+	const uint32_t ev_size = sizeof(LV2_Atom_Event) + lv2_atom_pad_size(3);
+	std::vector<uint64_t> buf(
+		(sizeof(LV2_Atom_Sequence) + n_events * ev_size) / sizeof(uint64_t));
+
+	std::vector<int64_t> times(n_events);
+	for (uint32_t i = 0; i < n_events; ++i) {
+		times[i] = rand() % nframes;
+	}
+	std::sort(times.begin(), times.end());
+
+	LV2_Atom_Sequence* seq = (LV2_Atom_Sequence*)buf.data();
+	seq->atom.size = sizeof(LV2_Atom_Sequence_Body) + n_events * ev_size;
+	seq->atom.type = 1;
+
+	LV2_Atom_Event* ev = lv2_atom_sequence_begin(&seq->body);
+	for (uint32_t i = 0; i < n_events; ++i) {
+		ev->time.frames = times[i];
+		ev->body.size   = 3;
+		ev->body.type   = 2;
+		memset((uint8_t*)LV2_ATOM_BODY_CONST(&ev->body), 0x90, 3);
+		ev = lv2_atom_sequence_next(ev);
+	}
+
+	return buf;
+}
+
+/** Merge by scanning every source for the earliest event each time. */
+template<typename Sink>
+static void
+scan_sequences(const LV2_Atom_Sequence* const* seqs,
+               uint32_t                        n_seqs,
+               Sink                            sink)
+{
+	const LV2_Atom_Event* iters[n_seqs];
+	for (uint32_t i = 0; i < n_seqs; ++i) {
+		iters[i] = lv2_atom_sequence_begin(&seqs[i]->body);
+		if (lv2_atom_sequence_is_end(&seqs[i]->body, seqs[i]->atom.size, iters[i])) {
+			iters[i] = NULL;
+		}
+	}
+
+	while (true) {
+		const LV2_Atom_Event* first   = NULL;
+		uint32_t              first_i = 0;
+		for (uint32_t i = 0; i < n_seqs; ++i) {
+			const LV2_Atom_Event* const ev = iters[i];
+			if (ev && (!first || ev->time.frames < first->time.frames)) {
+				first   = ev;
+				first_i = i;
+			}
+		}
+
+		if (!first) {
+			break;
+		}
+
+		sink(first);
+		iters[first_i] = lv2_atom_sequence_next(first);
+		if (lv2_atom_sequence_is_end(&seqs[first_i]->body,
+		                             seqs[first_i]->atom.size,
+		                             iters[first_i])) {
+			iters[first_i] = NULL;
+		}
+	}
+}
+
+/** Return the mean time in nanoseconds per merged event. */
+template<typename Merge>
+static double
+time_merge(Merge merge, uint32_t n_events)
+{
+	static const unsigned n_runs = 1000;
+
+	const Clock::time_point start = Clock::now();
+	for (unsigned r = 0; r < n_runs; ++r) {
+		merge();
+	}
+	const Clock::duration elapsed = Clock::now() - start;
+
+	return std::chrono::duration<double, std::nano>(elapsed).count()
+		/ (n_runs * n_events);
+}
+
+int
+main()
+{
+	cout << "# sources\tmerge (ns/event)\tscan (ns/event)" << endl;
+	for (uint32_t n_srcs = 1; n_srcs <= 256; n_srcs *= 2) {
+		std::vector< std::vector<uint64_t> > bufs;
+		std::vector<const LV2_Atom_Sequence*> seqs;
+		for (uint32_t i = 0; i < n_srcs; ++i) {
+			bufs.push_back(make_sequence(events_per_source));
+			seqs.push_back((const LV2_Atom_Sequence*)bufs.back().data());
+		}
+
+		// Check that merging gives the same order as scanning
+		std::vector<const LV2_Atom_Event*> merged;
+		std::vector<const LV2_Atom_Event*> scanned;
+		merge_sequences(seqs.data(), n_srcs, [&](const LV2_Atom_Event* ev) {
+				merged.push_back(ev);
+			});
+		scan_sequences(seqs.data(), n_srcs, [&](const LV2_Atom_Event* ev) {
+				scanned.push_back(ev);
+			});
+		if (merged != scanned) {
+			cerr << "error: merge order differs with " << n_srcs << " sources"
+			     << endl;
+			return EXIT_FAILURE;
+		}
+
+		const uint32_t n_events = n_srcs * events_per_source;
+		const auto     count    = [](const LV2_Atom_Event* ev) {
+			total += ev->time.frames;
+		};
+
+		const double merge = time_merge([&]() {
+				merge_sequences(seqs.data(), n_srcs, count);
+			}, n_events);
+		const double scan = time_merge([&]() {
+				scan_sequences(seqs.data(), n_srcs, count);
+			}, n_events);
+
+		cout << n_srcs << "\t" << merge << "\t" << scan << endl;
+	}
+
+	return 0;
+}
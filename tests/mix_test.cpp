@@ -0,0 +1,84 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Test for the audio mixing kernels.
+ *
+ * Every source count and a range of block lengths, including ones that are
+ * not a multiple of any vector width, are summed with the vector kernels and
+ * with the scalar kernel.  Sources are added in the same order in every
+ * lane, so results must be exactly equal.
+ */
+
+#include <stdlib.h>
+
+#include <iostream>
+#include <vector>
+
+#include "../src/server/sum.hpp"
+
+using namespace std;
+using namespace Ingen::Server;
+
+static const uint32_t max_srcs   = 13;
+static const uint32_t max_frames = 67;
+
+template<unsigned W>
+static bool
+check_width(const std::vector<std::vector<Sample>>& bufs)
+{
+	std::vector<const Sample*> srcs;
+	for (const auto& b : bufs) {
+		srcs.push_back(b.data());
+	}
+
+	for (uint32_t n_srcs = 0; n_srcs <= max_srcs; ++n_srcs) {
+		for (uint32_t nframes = 0; nframes <= max_frames; ++nframes) {
+			const Sample constant = n_srcs * 0.1f;
+
+			// Offset output so unaligned stores are tested too
+			std::vector<Sample> expected(max_frames + 1, -1.0f);
+			std::vector<Sample> actual(max_frames + 1, -1.0f);
+			sum_audio<1>(&expected[1], srcs.data(), n_srcs, constant, nframes);
+			sum_audio<W>(&actual[1], srcs.data(), n_srcs, constant, nframes);
+
+			if (actual != expected) {
+				cerr << "mix_test: Error: Width " << W << " sum of "
+				     << n_srcs << " sources over " << nframes
+				     << " frames differs from scalar sum" << endl;
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+int
+main()
+{
+	std::vector<std::vector<Sample>> bufs(max_srcs);
+	for (auto& b : bufs) {
+		for (uint32_t i = 0; i < max_frames; ++i) {
+			b.push_back(rand() / (Sample)RAND_MAX - 0.5f);
+		}
+	}
+
+	if (!check_width<4>(bufs) || !check_width<8>(bufs)) {
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
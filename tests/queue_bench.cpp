@@ -0,0 +1,134 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Stress benchmark for the engine event queue.
+ *
+ * This enqueues events from 1 to 16 threads at once while the engine runs,
+ * and times how long it takes to enqueue them, and to completely process
+ * them.  The events are requests for an object that does not exist, so
+ * almost all of the time is spent moving them through the queue.
+ */
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <glibmm/thread.h>
+
+#include "raul/URI.hpp"
+
+#include "ingen/EngineBase.hpp"
+#include "ingen/Interface.hpp"
+#include "ingen/World.hpp"
+#include "ingen/runtime_paths.hpp"
+#include "ingen/types.hpp"
+
+using namespace std;
+using namespace Ingen;
+
+typedef std::chrono::steady_clock Clock;
+
+static const unsigned events_per_producer = 100000;
+
+World* world = NULL;
+
+static void
+ingen_try(bool cond, const char* msg)
+{
+	if (!cond) {
+		cerr << "ingen: Error: " << msg << endl;
+		delete world;
+		exit(EXIT_FAILURE);
+	}
+}
+
+static double
+seconds(Clock::duration d)
+{
+	return std::chrono::duration<double>(d).count();
+}
+
+static void
+bench(Interface& iface, unsigned n_producers)
+{
+	const Raul::URI          uri("ingen:/nothing");
+	std::atomic<unsigned>    n_finished(0);
+	std::vector<std::thread> producers;
+
+	const Clock::time_point start = Clock::now();
+	for (unsigned p = 0; p < n_producers; ++p) {
+		producers.emplace_back([&]() {
+				for (unsigned i = 0; i < events_per_producer; ++i) {
+					iface.get(uri);
+				}
+				++n_finished;
+			});
+	}
+
+	// Run the engine until every producer is finished and the queue is empty
+	while (n_finished < n_producers || world->engine()->pending_events()) {
+		world->engine()->run(4096);
+		world->engine()->main_iteration();
+	}
+	const Clock::time_point end = Clock::now();
+
+	for (std::thread& t : producers) {
+		t.join();
+	}
+
+	const double n_events = double(n_producers) * events_per_producer;
+	cout << n_producers << "\t" << n_events / seconds(end - start) << endl;
+}
+
+int
+main(int argc, char** argv)
+{
+	Glib::thread_init();
+	set_bundle_path_from_code((void*)&main);
+
+	// Create world
+	try {
+		world = new World(argc, argv, NULL, NULL, NULL);
+	} catch (std::exception& e) {
+		cout << "ingen: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Load modules
+	ingen_try(world->load_module("server_profiled"),
+	          "Unable to load server module");
+
+	// Initialise engine
+	ingen_try(bool(world->engine()),
+	          "Unable to create engine");
+	world->engine()->init(48000.0, 4096, 4096);
+	world->engine()->activate();
+
+	cout << "# producers\tevents/s" << endl;
+	for (unsigned n_producers : { 1, 2, 4, 8, 16 }) {
+		bench(*world->interface(), n_producers);
+	}
+
+	// Shut down
+	world->engine()->deactivate();
+
+	delete world;
+	return 0;
+}
@@ -0,0 +1,164 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Test for enqueuing events from several threads at once.
+ *
+ * Each producer thread sets a port of its own to increasing values while the
+ * engine runs.  Events from one thread must be processed in the order they
+ * were sent, so when everything is processed, every port must have the last
+ * value sent to it.
+ */
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glibmm/thread.h>
+
+#include "raul/Path.hpp"
+
+#include "ingen/EngineBase.hpp"
+#include "ingen/Interface.hpp"
+#include "ingen/Node.hpp"
+#include "ingen/Store.hpp"
+#include "ingen/URIs.hpp"
+#include "ingen/World.hpp"
+#include "ingen/runtime_paths.hpp"
+#include "ingen/types.hpp"
+
+using namespace std;
+using namespace Ingen;
+
+static const unsigned n_producers         = 8;
+static const unsigned events_per_producer = 10000;
+
+World* world = NULL;
+
+static void
+test_try(bool cond, const char* msg)
+{
+	if (!cond) {
+		cerr << "queue_test: Error: " << msg << endl;
+		delete world;
+		exit(EXIT_FAILURE);
+	}
+}
+
+/** Run the engine until every event sent so far has been processed. */
+static void
+settle()
+{
+	while (world->engine()->pending_events()) {
+		world->engine()->run(4096);
+		world->engine()->main_iteration();
+	}
+}
+
+static Raul::Path
+port_path(unsigned p)
+{
+	return Raul::Path("/queue/p" + std::to_string(p));
+}
+
+int
+main(int argc, char** argv)
+{
+	Glib::thread_init();
+	set_bundle_path_from_code((void*)&main);
+
+	// Create world
+	try {
+		world = new World(argc, argv, NULL, NULL, NULL);
+	} catch (std::exception& e) {
+		cout << "ingen: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Load modules
+	test_try(world->load_module("server_profiled"),
+	         "Unable to load server module");
+
+	// Initialise engine
+	test_try(bool(world->engine()), "Unable to create engine");
+	world->engine()->init(48000.0, 4096, 4096);
+	world->engine()->activate();
+
+	// Create a graph with a control input for each producer
+	Interface&  iface = *world->interface();
+	const URIs& uris  = world->uris();
+
+	Resource::Properties props;
+	props.insert(make_pair(uris.rdf_type,
+	                       Resource::Property(uris.ingen_Graph)));
+	iface.put(Node::path_to_uri(Raul::Path("/queue")), props);
+	for (unsigned p = 0; p < n_producers; ++p) {
+		Resource::Properties port_props;
+		port_props.insert(make_pair(uris.rdf_type,
+		                            Resource::Property(uris.lv2_InputPort)));
+		port_props.insert(make_pair(uris.rdf_type,
+		                            Resource::Property(uris.lv2_ControlPort)));
+		iface.put(Node::path_to_uri(port_path(p)), port_props);
+	}
+	settle();
+
+	// Set every port from its own thread while the engine runs
+	std::atomic<unsigned>    n_finished(0);
+	std::vector<std::thread> producers;
+	for (unsigned p = 0; p < n_producers; ++p) {
+		producers.emplace_back([&, p]() {
+				const Raul::URI uri = Node::path_to_uri(port_path(p));
+				for (unsigned i = 1; i <= events_per_producer; ++i) {
+					iface.set_property(uri, uris.ingen_value,
+					                   uris.forge.make(float(i)));
+				}
+				++n_finished;
+			});
+	}
+
+	while (n_finished < n_producers || world->engine()->pending_events()) {
+		world->engine()->run(4096);
+		world->engine()->main_iteration();
+	}
+
+	for (std::thread& t : producers) {
+		t.join();
+	}
+
+	// Check that the last value sent to each port was the last one set
+	{
+		const SPtr<Store> store = world->store();
+		SharedLock        lock(store->mutex());
+		for (unsigned p = 0; p < n_producers; ++p) {
+			const Node* const port = store->get(port_path(p));
+			test_try(port, "Port does not exist");
+
+			const Atom& value = port->get_property(uris.ingen_value);
+			test_try(value.type() == uris.forge.Float &&
+			         value.get<float>() == float(events_per_producer),
+			         "Events from one thread processed out of order");
+		}
+	}
+
+	// Shut down
+	world->engine()->deactivate();
+
+	delete world;
+	return 0;
+}
@@ -0,0 +1,162 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Benchmark for socket message throughput.
+ *
+ * This sends port value changes through a socket pair with a SocketWriter on
+ * one end and a SocketReader on the other, in both the Turtle and atom
+ * formats, and times how long it takes for every message to be received.
+ */
+
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <glibmm/thread.h>
+
+#include "raul/Socket.hpp"
+#include "raul/URI.hpp"
+
+#include "ingen/AtomStream.hpp"
+#include "ingen/Forge.hpp"
+#include "ingen/Interface.hpp"
+#include "ingen/SocketReader.hpp"
+#include "ingen/SocketWriter.hpp"
+#include "ingen/URIs.hpp"
+#include "ingen/World.hpp"
+#include "ingen/runtime_paths.hpp"
+#include "ingen/types.hpp"
+
+using namespace std;
+using namespace Ingen;
+
+typedef std::chrono::steady_clock Clock;
+
+static const unsigned n_messages = 100000;
+
+World* world = NULL;
+
+/** An Interface that counts received set_property messages. */
+class Counter : public Interface
+{
+public:
+	Counter() : count(0) {}
+
+	Raul::URI uri() const { return Raul::URI("ingen:/counter"); }
+
+	void bundle_begin() {}
+	void bundle_end() {}
+	void put(const Raul::URI&, const Resource::Properties&, Resource::Graph) {}
+	void delta(const Raul::URI&,
+	           const Resource::Properties&,
+	           const Resource::Properties&) {}
+	void copy(const Raul::URI&, const Raul::URI&) {}
+	void move(const Raul::Path&, const Raul::Path&) {}
+	void del(const Raul::URI&) {}
+	void connect(const Raul::Path&, const Raul::Path&) {}
+	void disconnect(const Raul::Path&, const Raul::Path&) {}
+	void disconnect_all(const Raul::Path&, const Raul::Path&) {}
+	void set_response_id(int32_t) {}
+	void get(const Raul::URI&) {}
+	void response(int32_t, Status, const std::string&) {}
+	void error(const std::string&) {}
+
+	void set_property(const Raul::URI&, const Raul::URI&, const Atom&) {
+		++count;
+	}
+
+	std::atomic<unsigned> count;
+};
+
+static SPtr<Raul::Socket>
+wrap(int fd)
+{
+	return SPtr<Raul::Socket>(
+		new Raul::Socket(Raul::Socket::Type::UNIX,
+		                 Raul::URI("unix:///socket_bench"),
+		                 NULL,
+		                 0,
+		                 fd));
+}
+
+/** Return the number of messages received per second in `format`. */
+static double
+bench(AtomStream::Format format)
+{
+	int fds[2];
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds)) {
+		cerr << "socket_bench: Failed to create socket pair" << endl;
+		return 0.0;
+	}
+
+	const URIs&        uris = world->uris();
+	const Raul::URI    port("ingen:/main/block/port");
+	SPtr<Raul::Socket> out  = wrap(fds[0]);
+	SPtr<Raul::Socket> in   = wrap(fds[1]);
+	Counter            counter;
+	double             rate = 0.0;
+	{
+		SocketWriter writer(world->uri_map(),
+		                    world->uris(),
+		                    out->uri(),
+		                    out,
+		                    format);
+		SocketReader reader(*world, counter, in, format);
+
+		const Clock::time_point start = Clock::now();
+		for (unsigned i = 0; i < n_messages; ++i) {
+			writer.set_property(port,
+			                    uris.ingen_value,
+			                    world->forge().make((float)i));
+		}
+		while (counter.count < n_messages) {
+			std::this_thread::yield();
+		}
+		const Clock::duration elapsed = Clock::now() - start;
+
+		rate = n_messages / std::chrono::duration<double>(elapsed).count();
+		out->shutdown();
+	}
+
+	return rate;
+}
+
+int
+main(int argc, char** argv)
+{
+	Glib::thread_init();
+	set_bundle_path_from_code((void*)&main);
+
+	// Create world
+	try {
+		world = new World(argc, argv, NULL, NULL, NULL);
+	} catch (std::exception& e) {
+		cout << "ingen: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	cout << "# format\tmessages/s" << endl;
+	cout << "turtle\t" << bench(AtomStream::Format::TURTLE) << endl;
+	cout << "atom\t" << bench(AtomStream::Format::ATOM) << endl;
+
+	delete world;
+	return 0;
+}
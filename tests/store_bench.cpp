@@ -0,0 +1,183 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Benchmark for event pre-processing on a large store.
+ *
+ * This builds a graph of internal delay blocks with 100000 objects in total,
+ * then times how many events per second the engine can process when each
+ * event refers to a random object: setting a port value, setting a block
+ * label, and connecting and disconnecting a pair of ports.  These are
+ * dominated by looking up objects in the store during pre-processing.
+ */
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <glibmm/thread.h>
+
+#include "raul/Path.hpp"
+
+#include "ingen/EngineBase.hpp"
+#include "ingen/Interface.hpp"
+#include "ingen/Node.hpp"
+#include "ingen/URIs.hpp"
+#include "ingen/World.hpp"
+#include "ingen/runtime_paths.hpp"
+#include "ingen/types.hpp"
+
+using namespace std;
+using namespace Ingen;
+
+typedef std::chrono::steady_clock Clock;
+
+static const char* const delay_uri =
+	"http://drobilla.net/ns/ingen-internals#Delay";
+
+static const unsigned n_blocks = 25000;  // Each with 3 ports
+static const unsigned n_events = 100000;
+
+World* world = NULL;
+
+static void
+ingen_try(bool cond, const char* msg)
+{
+	if (!cond) {
+		cerr << "ingen: Error: " << msg << endl;
+		delete world;
+		exit(EXIT_FAILURE);
+	}
+}
+
+/** Run the engine until every event sent so far has been processed. */
+static void
+settle()
+{
+	while (world->engine()->pending_events()) {
+		world->engine()->run(4096);
+		world->engine()->main_iteration();
+	}
+	world->engine()->main_iteration();
+}
+
+static Raul::Path
+block_path(unsigned i)
+{
+	return Raul::Path("/bench").child(Raul::Symbol("d" + std::to_string(i)));
+}
+
+static Raul::URI
+port_uri(unsigned i, const char* symbol)
+{
+	return Node::path_to_uri(block_path(i).child(Raul::Symbol(symbol)));
+}
+
+/** Print the number of events per second processed by `send`.
+ *
+ * @param n_sent Number of events sent by each call of `send`.
+ */
+template<typename Send>
+static void
+time_events(const char* name, unsigned n_sent, Send send)
+{
+	const Clock::time_point start = Clock::now();
+	for (unsigned e = 0; e < n_events; ++e) {
+		send(rand() % n_blocks);
+		if (e % 1000 == 999) {
+			settle();
+		}
+	}
+	settle();
+	const Clock::duration elapsed = Clock::now() - start;
+
+	cout << name << "\t"
+	     << n_events * n_sent / std::chrono::duration<double>(elapsed).count()
+	     << endl;
+}
+
+int
+main(int argc, char** argv)
+{
+	Glib::thread_init();
+	set_bundle_path_from_code((void*)&main);
+
+	// Create world
+	try {
+		world = new World(argc, argv, NULL, NULL, NULL);
+	} catch (std::exception& e) {
+		cout << "ingen: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	// Load modules
+	ingen_try(world->load_module("server_profiled"),
+	          "Unable to load server module");
+
+	// Initialise engine
+	ingen_try(bool(world->engine()),
+	          "Unable to create engine");
+	world->engine()->init(48000.0, 4096, 4096);
+	world->engine()->activate();
+
+	Interface&  iface = *world->interface();
+	const URIs& uris  = world->uris();
+
+	// Build a graph of unconnected delay blocks
+	Resource::Properties props;
+	props.put(uris.rdf_type, uris.ingen_Graph);
+	iface.put(Node::path_to_uri(Raul::Path("/bench")), props);
+	for (unsigned i = 0; i < n_blocks; ++i) {
+		Resource::Properties block_props;
+		block_props.put(uris.rdf_type, uris.ingen_Block);
+		block_props.put(uris.lv2_prototype,
+		                uris.forge.make_urid(Raul::URI(delay_uri)));
+		iface.put(Node::path_to_uri(block_path(i)), block_props);
+		if (i % 1000 == 999) {
+			settle();
+		}
+	}
+	settle();
+
+	cout << "# event\tevents/s" << endl;
+
+	time_events("value", 1, [&](unsigned i) {
+			iface.set_property(port_uri(i, "delay"),
+			                   uris.ingen_value,
+			                   uris.forge.make(float(rand() % 100) / 100.0f));
+		});
+
+	time_events("label", 1, [&](unsigned i) {
+			iface.set_property(Node::path_to_uri(block_path(i)),
+			                   uris.rdfs_label,
+			                   uris.forge.alloc(std::to_string(rand())));
+		});
+
+	time_events("connect", 2, [&](unsigned i) {
+			const unsigned   j    = (i + 1) % n_blocks;
+			const Raul::Path tail = block_path(i).child(Raul::Symbol("out"));
+			const Raul::Path head = block_path(j).child(Raul::Symbol("in"));
+			iface.connect(tail, head);
+			iface.disconnect(tail, head);
+		});
+
+	// Shut down
+	world->engine()->deactivate();
+
+	delete world;
+	return 0;
+}
@@ -0,0 +1,119 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Contention benchmark for URID mapping.
+ *
+ * This maps URIs from 1 to 16 threads at once through the LV2 URID map
+ * feature given to plugins, and prints the number of maps per second.  Each
+ * thread first maps URIs that are already mapped, as plugins do when they
+ * are instantiated, then maps the same number of new URIs.
+ */
+
+#include <stdlib.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glibmm/thread.h>
+
+#include "ingen/URIMap.hpp"
+#include "ingen/World.hpp"
+
+using namespace std;
+using namespace Ingen;
+
+typedef std::chrono::steady_clock Clock;
+
+static const unsigned n_uris          = 1000;
+static const unsigned maps_per_thread = 1000000;
+
+/** Return the mean number of maps per second with `n_threads` at once. */
+template<typename URI>
+static double
+time_maps(LV2_URID_Map* map, unsigned n_threads, unsigned n_maps, URI uri)
+{
+	std::vector<std::thread> threads;
+
+	const Clock::time_point start = Clock::now();
+	for (unsigned t = 0; t < n_threads; ++t) {
+		threads.emplace_back([=]() {
+				for (unsigned i = 0; i < n_maps; ++i) {
+					map->map(map->handle, uri(t, i));
+				}
+			});
+	}
+	for (std::thread& t : threads) {
+		t.join();
+	}
+	const Clock::duration elapsed = Clock::now() - start;
+
+	return double(n_threads) * n_maps
+		/ std::chrono::duration<double>(elapsed).count();
+}
+
+int
+main(int argc, char** argv)
+{
+	Glib::thread_init();
+
+	World* world = NULL;
+	try {
+		world = new World(argc, argv, NULL, NULL, NULL);
+	} catch (std::exception& e) {
+		cout << "ingen: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	LV2_URID_Map* map = &world->uri_map().urid_map_feature()->urid_map;
+
+	// Make URI strings up front so only mapping is timed
+	std::vector<std::string> existing;
+	for (unsigned i = 0; i < n_uris; ++i) {
+		existing.push_back("http://example.org/bench#" + std::to_string(i));
+		map->map(map->handle, existing.back().c_str());
+	}
+
+	cout << "# threads\texisting (maps/s)\tnew (maps/s)" << endl;
+	unsigned round = 0;
+	for (unsigned n_threads : { 1, 2, 4, 8, 16 }) {
+		const double hits = time_maps(
+			map, n_threads, maps_per_thread, [&](unsigned, unsigned i) {
+				return existing[i % n_uris].c_str();
+			});
+
+		std::vector<std::string> fresh;
+		for (unsigned t = 0; t < n_threads; ++t) {
+			for (unsigned i = 0; i < n_uris; ++i) {
+				fresh.push_back("http://example.org/new" + std::to_string(round)
+				                + "/" + std::to_string(t) + "#" + std::to_string(i));
+			}
+		}
+		++round;
+
+		const double misses = time_maps(
+			map, n_threads, n_uris, [&](unsigned t, unsigned i) {
+				return fresh[t * n_uris + i].c_str();
+			});
+
+		cout << n_threads << "\t" << hits << "\t" << misses << endl;
+	}
+
+	delete world;
+	return 0;
+}
@@ -0,0 +1,142 @@
+/*
+  This file is part of Ingen.
+  Copyright 2007-2015 David Robillard <http://drobilla.net/>
+
+  Ingen is free software: you can redistribute it and/or modify it under the
+  terms of the GNU Affero General Public License as published by the Free
+  Software Foundation, either version 3 of the License, or any later version.
+
+  Ingen is distributed in the hope that it will be useful, but WITHOUT ANY
+  WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS FOR
+  A PARTICULAR PURPOSE.  See the GNU Affero General Public License for details.
+
+  You should have received a copy of the GNU Affero General Public License
+  along with Ingen.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+/** Test for mapping URIs from several threads at once.
+ *
+ * Every thread maps the same set of URIs, in a different order so that new
+ * URIs race with each other, then a set of its own.  Every thread must get
+ * the same URID for the same URI, different URIs must get different URIDs,
+ * and every URID must unmap back to the URI it was mapped from.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <iostream>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <glibmm/thread.h>
+
+#include "ingen/URIMap.hpp"
+#include "ingen/World.hpp"
+
+using namespace std;
+using namespace Ingen;
+
+static const unsigned n_threads = 8;
+static const unsigned n_uris    = 2000;
+
+World* world = NULL;
+
+static void
+test_try(bool cond, const char* msg)
+{
+	if (!cond) {
+		cerr << "urid_test: Error: " << msg << endl;
+		delete world;
+		exit(EXIT_FAILURE);
+	}
+}
+
+int
+main(int argc, char** argv)
+{
+	Glib::thread_init();
+
+	// Create world
+	try {
+		world = new World(argc, argv, NULL, NULL, NULL);
+	} catch (std::exception& e) {
+		cout << "ingen: " << e.what() << endl;
+		return EXIT_FAILURE;
+	}
+
+	LV2_URID_Map*   map   = &world->uri_map().urid_map_feature()->urid_map;
+	LV2_URID_Unmap* unmap = &world->uri_map().urid_unmap_feature()->urid_unmap;
+
+	// Make URI strings up front: shared ones, then a set for each thread
+	std::vector<std::string> uris;
+	for (unsigned i = 0; i < n_uris; ++i) {
+		uris.push_back("http://example.org/shared#" + std::to_string(i));
+	}
+	for (unsigned t = 0; t < n_threads; ++t) {
+		for (unsigned i = 0; i < n_uris; ++i) {
+			uris.push_back("http://example.org/own" + std::to_string(t)
+			               + "#" + std::to_string(i));
+		}
+	}
+
+	// Map every URI from several threads at once
+	std::vector<std::vector<LV2_URID>> ids(n_threads);
+	std::vector<std::thread>           threads;
+	for (unsigned t = 0; t < n_threads; ++t) {
+		threads.emplace_back([&, t]() {
+				std::vector<LV2_URID>& mine = ids[t];
+				mine.resize(n_uris * 2);
+				for (unsigned i = 0; i < n_uris; ++i) {
+					// Odd threads map shared URIs backwards
+					const unsigned j = (t % 2) ? n_uris - 1 - i : i;
+					mine[j] = map->map(map->handle, uris[j].c_str());
+				}
+				for (unsigned i = 0; i < n_uris; ++i) {
+					const std::string& uri = uris[(t + 1) * n_uris + i];
+					mine[n_uris + i] = map->map(map->handle, uri.c_str());
+				}
+			});
+	}
+	for (std::thread& t : threads) {
+		t.join();
+	}
+
+	// Check that shared URIs have the same URID in every thread
+	for (unsigned t = 1; t < n_threads; ++t) {
+		for (unsigned i = 0; i < n_uris; ++i) {
+			test_try(ids[t][i] == ids[0][i],
+			         "Same URI mapped to different URIDs");
+		}
+	}
+
+	// Check that every URI has a distinct URID that unmaps back to it
+	std::set<LV2_URID> seen;
+	for (unsigned t = 0; t < n_threads; ++t) {
+		for (unsigned i = 0; i < n_uris * 2; ++i) {
+			const LV2_URID     id  = ids[t][i];
+			const std::string& uri = uris[i < n_uris ? i : t * n_uris + i];
+			test_try(id != 0, "URI mapped to zero");
+
+			const char* str = unmap->unmap(unmap->handle, id);
+			test_try(str && !strcmp(str, uri.c_str()),
+			         "URID does not unmap to the URI it was mapped from");
+
+			if (t == 0 || i >= n_uris) {  // Shared URIs are only counted once
+				test_try(seen.insert(id).second,
+				         "Different URIs mapped to the same URID");
+			}
+		}
+	}
+
+	// Check that mapping again is stable
+	for (unsigned i = 0; i < n_uris; ++i) {
+		test_try(map->map(map->handle, uris[i].c_str()) == ids[0][i],
+		         "Mapping a URI again gave a different URID");
+	}
+
+	delete world;
+	return 0;
+}